@@ -0,0 +1,649 @@
+// Copyright (c) 1981-86 Robert A. Koeneke
+// Copyright (c) 1987-94 James E. Wilson
+//
+// This work is free software released under the GNU General Public License
+// version 2.0, and comes with ABSOLUTELY NO WARRANTY.
+//
+// See LICENSE and AUTHORS for more information.
+
+// Micro-benchmarks for the engine hot paths.
+//
+// The game is run with the headless terminal, and each case is timed with
+// a fixed seed so results are comparable between builds. The results are
+// written to stdout as JSON.
+//
+//   umoria_bench [LEVELS]
+//   umoria_bench --check
+//
+// LEVELS is the number of levels generated for each case (default: 20).
+// With --check, the engine is checked for known problems instead, and the
+// exit status is non-zero when any are found.
+
+#include "../src/headers.h"
+
+#include <chrono>
+#include <vector>
+
+#include <sys/wait.h>
+
+using bench_clock = std::chrono::steady_clock;
+
+constexpr uint32_t BENCH_SEED = 1234567;
+
+// Monsters on a busy level, which was all of them when the pool held 125.
+constexpr int BENCH_MONSTERS = 125;
+static const char *bench_save_file = "umoria_bench.sav";
+
+static bool first_result = true;
+
+static int64_t elapsedNanoseconds(bench_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now() - start).count();
+}
+
+static void printResult(const char *name, int depth, int64_t operations, int64_t nanoseconds, const char *rate_name = "ops_per_sec") {
+    double ns_per_op = operations > 0 ? (double) nanoseconds / (double) operations : 0;
+
+    printf("%s\n    {\"name\": \"%s\", \"depth\": %d, \"ops\": %lld, \"ns_per_op\": %.1f", first_result ? "" : ",", name, depth, (long long) operations, ns_per_op);
+
+    if (ns_per_op > 0) {
+        printf(", \"%s\": %.1f", rate_name, 1.0e9 / ns_per_op);
+    }
+    printf("}");
+
+    first_result = false;
+}
+
+// Headless output and an empty input, so that any -more- prompt
+// gets an ESCAPE rather than waiting on the terminal.
+static void benchResetInput() {
+    eof_flag = 0;
+    message_ready_to_print = false;
+    game.character_is_dead = false;
+}
+
+// A fixed human warrior, who can not be hurt by any monster attacks.
+static void benchCreateCharacter() {
+    (void) strcpy(py.misc.name, "Bench");
+    py.misc.race_id = 0;
+    py.misc.class_id = 0;
+    py.misc.level = 20;
+    py.misc.experience_factor = 100;
+    py.misc.hit_die = 10;
+    py.misc.max_hp = 500;
+    py.misc.current_hp = 500;
+    py.misc.date_of_birth = (int32_t) BENCH_SEED;
+    playerSetGender(true);
+
+    for (int i = 0; i < 6; i++) {
+        py.stats.max[i] = 15;
+        py.stats.current[i] = 15;
+        py.stats.used[i] = 15;
+    }
+
+    for (auto &item : inventory) {
+        inventoryItemCopyTo(config::dungeon::objects::OBJ_NOTHING, item);
+    }
+
+    py.flags.food = 7500;
+    py.flags.food_digested = 2;
+    py.flags.invulnerability = MAX_SHORT;
+
+    for (uint8_t &id : py.flags.spells_learned_order) {
+        id = 99;
+    }
+
+    game.character_generated = true;
+}
+
+static void benchInitialize() {
+    terminalSetHeadless();
+    (void) terminalInitialize();
+
+    // There are no keys to press when benchmarking.
+    if (freopen("/dev/null", "r", stdin) == nullptr) {
+        fclose(stdin);
+    }
+
+    dungeonSetScale(1);
+    seedsInitialize(BENCH_SEED);
+    initializeMonsterLevels();
+    initializeTreasureLevels();
+    storeInitializeOwners();
+    playerInitializeBaseExperienceLevels();
+    benchCreateCharacter();
+    magicInitializeItemNames();
+
+    config::files::save_game = bench_save_file;
+}
+
+// A new level, set up the same as playDungeon() does.
+static void benchGenerateLevel(int depth) {
+    dg.current_level = (int16_t) depth;
+    benchResetInput();
+    generateCave();
+
+    dg.generate_new_level = false;
+    dg.floor[py.row][py.col].creature_id = 1;
+}
+
+static void benchGenerateCave(int levels) {
+    int depths[] = {0, 1, 5, 10, 20, 30, 40, 50};
+
+    for (auto depth : depths) {
+        int64_t total = 0;
+
+        for (int i = 0; i < levels; i++) {
+            dg.current_level = (int16_t) depth;
+            benchResetInput();
+
+            auto start = bench_clock::now();
+            generateCave();
+            total += elapsedNanoseconds(start);
+        }
+
+        printResult("generateCave", depth, levels, total, "levels_per_sec");
+    }
+}
+
+// The largest levels, which need the whole floor and more of everything on it.
+static void benchGenerateLargeCave(int levels) {
+    int64_t total = 0;
+
+    dungeonSetScale(DUNGEON_SCALE_MAX);
+
+    for (int i = 0; i < levels; i++) {
+        dg.current_level = 20;
+        benchResetInput();
+
+        auto start = bench_clock::now();
+        generateCave();
+        total += elapsedNanoseconds(start);
+    }
+
+    dungeonSetScale(1);
+
+    printResult("generateCaveScale4", 20, levels, total, "levels_per_sec");
+}
+
+// Random pairs within monster sight of each other, as that is how los() is used.
+static void benchLineOfSight(int levels) {
+    constexpr int pairs_per_level = 20000;
+
+    std::vector<Coord_t> pairs;
+    int64_t total = 0;
+    int64_t operations = 0;
+    int visible = 0;
+
+    for (int i = 0; i < levels; i++) {
+        benchGenerateLevel(10);
+
+        pairs.clear();
+        while (pairs.size() < pairs_per_level * 2) {
+            Coord_t from = Coord_t{randomNumber(dg.height - 2), randomNumber(dg.width - 2)};
+            if (dg.floor[from.y][from.x].feature_id >= MIN_CLOSED_SPACE) {
+                continue;
+            }
+
+            int sight = config::monsters::MON_MAX_SIGHT;
+            Coord_t to = Coord_t{from.y + randomNumber(sight * 2 + 1) - sight - 1, from.x + randomNumber(sight * 2 + 1) - sight - 1};
+            if (!coordInBounds(to)) {
+                continue;
+            }
+
+            pairs.push_back(from);
+            pairs.push_back(to);
+        }
+
+        auto start = bench_clock::now();
+        for (size_t p = 0; p < pairs.size(); p += 2) {
+            if (los(pairs[p].y, pairs[p].x, pairs[p + 1].y, pairs[p + 1].x)) {
+                visible++;
+            }
+        }
+        total += elapsedNanoseconds(start);
+        operations += pairs_per_level;
+    }
+
+    // stop the compiler discarding the los() calls
+    if (visible < 0) {
+        printf("%d", visible);
+    }
+
+    printResult("los", 10, operations, total);
+}
+
+// Random targets around the player, over and over, as when monster visibility
+// is updated each turn. The same targets are used for several turns.
+static void benchLineOfSightFromPlayer(int levels) {
+    constexpr int targets_per_level = 500;
+    constexpr int turns_per_level = 40;
+
+    std::vector<Coord_t> targets;
+    int64_t total = 0;
+    int64_t operations = 0;
+    int visible = 0;
+
+    for (int i = 0; i < levels; i++) {
+        benchGenerateLevel(10);
+
+        targets.clear();
+        while (targets.size() < targets_per_level) {
+            int sight = config::monsters::MON_MAX_SIGHT;
+            Coord_t to = Coord_t{py.row + randomNumber(sight * 2 + 1) - sight - 1, py.col + randomNumber(sight * 2 + 1) - sight - 1};
+            if (coordInBounds(to)) {
+                targets.push_back(to);
+            }
+        }
+
+        auto start = bench_clock::now();
+        for (int turn = 0; turn < turns_per_level; turn++) {
+            for (auto const &to : targets) {
+                if (los(py.row, py.col, to.y, to.x)) {
+                    visible++;
+                }
+            }
+        }
+        total += elapsedNanoseconds(start);
+        operations += targets_per_level * turns_per_level;
+    }
+
+    // stop the compiler discarding the los() calls
+    if (visible < 0) {
+        printf("%d", visible);
+    }
+
+    printResult("losFromPlayer", 10, operations, total);
+}
+
+// Fill the level with awake monsters, then time each game turn of monster movement.
+static void benchUpdateMonsters(int levels) {
+    constexpr int turns_per_level = 200;
+
+    int64_t total = 0;
+    int64_t operations = 0;
+
+    for (int i = 0; i < levels; i++) {
+        benchGenerateLevel(20);
+        monsterPlaceNewWithinDistance(BENCH_MONSTERS - next_free_monster_id, 0, false);
+
+        for (int turn = 0; turn < turns_per_level && !dg.generate_new_level; turn++) {
+            benchResetInput();
+            dg.game_turn++;
+
+            auto start = bench_clock::now();
+            updateMonsters(true);
+            total += elapsedNanoseconds(start);
+            operations++;
+        }
+    }
+
+    printResult("updateMonsters", 20, operations, total);
+}
+
+// A busy level of monsters, with only the distance and visibility pass done
+// each turn, as happens after the player moves or a spell is cast.
+static void benchUpdateMonstersSight(int levels) {
+    constexpr int turns_per_level = 200;
+
+    int64_t total = 0;
+    int64_t operations = 0;
+
+    for (int i = 0; i < levels; i++) {
+        benchGenerateLevel(20);
+        monsterPlaceNewWithinDistance(BENCH_MONSTERS - next_free_monster_id, 0, false);
+
+        for (int turn = 0; turn < turns_per_level; turn++) {
+            benchResetInput();
+
+            auto start = bench_clock::now();
+            updateMonsters(false);
+            total += elapsedNanoseconds(start);
+            operations++;
+        }
+    }
+
+    printResult("updateMonstersSight", 20, operations, total);
+}
+
+// Darken a lit room, as if never seen, returning one of its tiles.
+static Coord_t benchDarkenRoom(Region_t const &region) {
+    Coord_t coord = Coord_t{-1, -1};
+
+    for (int y = region.top_left.y; y <= region.bottom_right.y; y++) {
+        for (int x = region.top_left.x; x <= region.bottom_right.x; x++) {
+            if (dg.floor.perma_lit_room.test(y, x)) {
+                dg.floor.permanent_light.reset(y, x);
+                if (coord.y < 0) {
+                    coord = Coord_t{y, x};
+                }
+            }
+        }
+    }
+
+    return coord;
+}
+
+// Light every room of the level, one at a time.
+static void benchLightRoom(int levels) {
+    constexpr int rounds_per_level = 10;
+
+    int64_t total = 0;
+    int64_t operations = 0;
+
+    for (int i = 0; i < levels; i++) {
+        benchGenerateLevel(5);
+
+        for (int round = 0; round < rounds_per_level; round++) {
+            for (auto const &region : dg.regions) {
+                Coord_t coord = benchDarkenRoom(region);
+
+                (void) coordOutsidePanel(coord, true);
+
+                auto start = bench_clock::now();
+                dungeonLightRoom(coord);
+                total += elapsedNanoseconds(start);
+                operations++;
+            }
+        }
+    }
+
+    printResult("dungeonLightRoom", 5, operations, total);
+}
+
+// loadGame() exits the program when it can't load the save file.
+static bool bench_loading = false;
+
+static void benchExit() {
+    if (bench_loading) {
+        fprintf(stderr, "loadGame() failed\n");
+        _exit(1);
+    }
+}
+
+static bool benchSaveAndLoad(int levels) {
+    int64_t save_total = 0;
+    int64_t load_total = 0;
+    int64_t operations = 0;
+
+    for (int i = 0; i < levels; i++) {
+        benchGenerateLevel(15);
+        monsterPlaceNewWithinDistance(50, 0, true);
+
+        for (int round = 0; round < 10; round++) {
+            benchResetInput();
+            (void) unlink(bench_save_file);
+            game.character_saved = false;
+            dg.game_turn = 1000;
+
+            auto start = bench_clock::now();
+            bool saved = saveGame();
+            save_total += elapsedNanoseconds(start);
+
+            if (!saved) {
+                fprintf(stderr, "saveGame() failed\n");
+                return false;
+            }
+
+            bool generate;
+            bench_loading = true;
+            start = bench_clock::now();
+            bool loaded = loadGame(generate);
+            load_total += elapsedNanoseconds(start);
+            bench_loading = false;
+
+            if (!loaded || generate) {
+                fprintf(stderr, "loadGame() failed\n");
+                return false;
+            }
+
+            operations++;
+        }
+    }
+
+    (void) unlink(bench_save_file);
+
+    printResult("saveGame", 15, operations, save_total);
+    printResult("loadGame", 15, operations, load_total);
+    printResult("saveLoadRoundTrip", 15, operations, save_total + load_total);
+
+    return true;
+}
+
+// A monster far across the largest levels must not have its distance from
+// the player wrap around once it moves, so looking as though it is close.
+static bool checkFarMonsterDistance() {
+    dungeonSetScale(DUNGEON_SCALE_MAX);
+    benchGenerateLevel(20);
+
+    int creature_id = 0;
+    while (creature_id < MON_MAX_CREATURES - 1 && (creatures_list[creature_id].level == 0 || (creatures_list[creature_id].movement & config::monsters::move::CM_ATTACK_ONLY) != 0u)) {
+        creature_id++;
+    }
+
+    bool placed = false;
+    bool moved = false;
+    bool ok = true;
+
+    for (int y = 1; y < dg.height - 1 && !placed; y++) {
+        for (int x = 1; x < dg.width - 1 && !placed; x++) {
+            Coord_t coord = Coord_t{y, x};
+            if (coordDistanceBetween(Coord_t{py.row, py.col}, coord) < 300 || dg.floor[y][x].feature_id > MAX_OPEN_SPACE || dg.floor[y][x].creature_id != 0 || coordWallsNextTo(coord) > 0) {
+                continue;
+            }
+            placed = monsterPlaceNew(y, x, creature_id, false);
+        }
+    }
+
+    for (int turn = 0; turn < 100 && placed && !moved; turn++) {
+        Monster_t &monster = monsters[next_free_monster_id - 1];
+        Coord_t from = Coord_t{monster.y, monster.x};
+
+        // seen by the player, so it gets its moves however far away it is
+        monster.lit = true;
+        benchResetInput();
+        dg.game_turn++;
+        updateMonsters(true);
+
+        moved = monster.y != from.y || monster.x != from.x;
+        if (moved && monster.distance_from_player != MAX_UCHAR) {
+            printf("far monster: distance %d after moving, expected %d\n", monster.distance_from_player, MAX_UCHAR);
+            ok = false;
+        }
+    }
+
+    if (!moved) {
+        printf("far monster: unable to place a monster which moves\n");
+        ok = false;
+    }
+
+    dungeonSetScale(1);
+
+    return ok;
+}
+
+// The playback exits the program when it ends, so is run in a child process,
+// which reports whether it got as far as saving the game with ^X.
+static void checkReplayExit() {
+    _exit(strcmp(game.character_died_from, "(saved)") == 0 ? 0 : 2);
+}
+
+// Playing back a game must never write the save file, not even when the
+// recording ends by saving the game with ^X.
+static bool checkReplayNotSaved() {
+    const char *replay_file = "umoria_bench.rec";
+
+    // A new character, who saves the game as soon as it is made.
+    if (!replayStartRecording(replay_file)) {
+        printf("replay save: unable to write %s\n", replay_file);
+        return false;
+    }
+    replayRecordStart(BENCH_SEED, true, false);
+    for (char key : std::string(" am\033aBench\r\033") + CTRL_KEY('X')) {
+        replayRecordKey(key);
+    }
+    replayStop();
+
+    (void) unlink(bench_save_file);
+    (void) fflush(stdout);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        // The game screen and the replay statistics are of no interest
+        if (freopen("/dev/null", "w", stdout) == nullptr || freopen("/dev/null", "w", stderr) == nullptr) {
+            _exit(1);
+        }
+
+        uint32_t seed;
+        bool new_game;
+        bool roguelike_keys;
+        if (!replayStartPlayback(replay_file, seed, new_game, roguelike_keys)) {
+            _exit(1);
+        }
+
+        (void) atexit(checkReplayExit);
+        startMoria((int) seed, new_game, roguelike_keys);
+        _exit(1);
+    }
+
+    int status = -1;
+    if (pid > 0) {
+        (void) waitpid(pid, &status, 0);
+    }
+
+    bool saved = access(bench_save_file, 0) == 0;
+
+    (void) unlink(replay_file);
+    (void) unlink(bench_save_file);
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("replay save: the playback did not reach the ^X which saves the game\n");
+        return false;
+    }
+    if (saved) {
+        printf("replay save: the playback wrote the save file\n");
+        return false;
+    }
+
+    return true;
+}
+
+// Jumping a stream ahead must land where drawing the numbers one at a
+// time from the game's stream does.
+static bool checkRngJumpAhead() {
+    bool ok = true;
+
+    for (uint64_t steps : {0, 1, 2, 7, 8, 100, 10000, 123457}) {
+        setRandomSeed(BENCH_SEED);
+        for (uint64_t i = 0; i < steps; i++) {
+            (void) rnd();
+        }
+
+        Rng_t rng;
+        rngSetSeed(rng, BENCH_SEED);
+        rngJumpAhead(rng, steps);
+
+        if (rng.seed != getRandomSeed()) {
+            printf("rng jump ahead: %llu steps gave %u, expected %u\n", (unsigned long long) steps, rng.seed, getRandomSeed());
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+// Filling a buffer of numbers in one go must give the same numbers, and
+// leave the stream in the same place, as calling rnd() for each of them.
+// So must rolling a buffer of dice, compared to rolling them one by one.
+static bool checkRngFill() {
+    bool ok = true;
+
+    std::vector<int32_t> values;
+
+    for (int count : {1, 2, 7, 8, 9, 16, 17, 255, 1000}) {
+        values.assign((size_t) count, 0);
+
+        Rng_t rng;
+        rngSetSeed(rng, BENCH_SEED);
+        rngFill(rng, values.data(), count);
+
+        bool same = true;
+
+        setRandomSeed(BENCH_SEED);
+        for (int i = 0; i < count; i++) {
+            int32_t value = rnd();
+            if (same && values[i] != value) {
+                printf("rng fill: number %d of %d is %d, expected %d\n", i, count, values[i], value);
+                same = false;
+            }
+        }
+        ok = ok && same;
+
+        if (rng.seed != getRandomSeed()) {
+            printf("rng fill: %d numbers left the stream at %u, expected %u\n", count, rng.seed, getRandomSeed());
+            ok = false;
+        }
+
+        std::vector<int> rolls((size_t) count);
+
+        setRandomSeed(BENCH_SEED);
+        randomNumbers(rolls.data(), count, 6);
+
+        setRandomSeed(BENCH_SEED);
+        for (int i = 0; i < count; i++) {
+            int roll = randomNumber(6);
+            if (rolls[i] != roll) {
+                printf("rng fill: roll %d of %d is %d, expected %d\n", i, count, rolls[i], roll);
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    return ok;
+}
+
+static int benchCheck() {
+    bool ok = checkFarMonsterDistance();
+    ok = checkReplayNotSaved() && ok;
+    ok = checkRngJumpAhead() && ok;
+    ok = checkRngFill() && ok;
+
+    printf("%s\n", ok ? "All checks passed" : "Checks failed");
+
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--check") == 0) {
+        benchInitialize();
+        return benchCheck();
+    }
+
+    int levels = 20;
+    if (argc > 1 && (!stringToNumber(argv[1], levels) || levels < 1)) {
+        fprintf(stderr, "Usage: umoria_bench [LEVELS | --check]\n");
+        return 1;
+    }
+
+    benchInitialize();
+
+    printf("{\n  \"seed\": %u,\n  \"levels\": %d,\n  \"results\": [", BENCH_SEED, levels);
+
+    benchGenerateCave(levels);
+    benchGenerateLargeCave(levels);
+    benchLineOfSight(levels);
+    benchLineOfSightFromPlayer(levels);
+    benchUpdateMonsters(levels);
+    benchUpdateMonstersSight(levels);
+    benchLightRoom(levels);
+
+    (void) atexit(benchExit);
+    if (!benchSaveAndLoad(levels)) {
+        (void) unlink(bench_save_file);
+        return 1;
+    }
+
+    printf("\n  ]\n}\n");
+
+    return 0;
+}
@@ -10,9 +10,13 @@
 
 // generates damage for 2d6 style dice rolls
 int diceRoll(Dice_t const &dice) {
+    // all the dice are rolled in one go
+    int rolls[UINT8_MAX];
+    randomNumbers(rolls, dice.dice, dice.sides);
+
     auto sum = 0;
     for (auto i = 0; i < dice.dice; i++) {
-        sum += randomNumber(dice.sides);
+        sum += rolls[i];
     }
     return sum;
 }
@@ -12,7 +12,94 @@
 
 // The Dungeon global
 // Yup, this initialization is ugly, we'll fix...eventually! -MRC-
-Dungeon_t dg = Dungeon_t{0, 0, {}, -1, 0, true, {}};
+Dungeon_t dg = Dungeon_t{0, 0, 1, {}, -1, 0, true, {}, {}};
+
+// Sets the dungeon levels to `scale` times the normal height and width,
+// and makes room for their tiles, which are all left blank.
+void dungeonSetScale(int scale) {
+    if (scale < 1) {
+        scale = 1;
+    } else if (scale > DUNGEON_SCALE_MAX) {
+        scale = DUNGEON_SCALE_MAX;
+    }
+
+    dg.scale = (uint8_t) scale;
+
+    // round up to whole chunks
+    Floor_t &floor = dg.floor;
+    floor.height = (int16_t) ((DUNGEON_HEIGHT * scale + FLOOR_CHUNK_MASK) & ~FLOOR_CHUNK_MASK);
+    floor.width = (int16_t) ((DUNGEON_WIDTH * scale + FLOOR_CHUNK_MASK) & ~FLOOR_CHUNK_MASK);
+    floor.chunk_row_size = floor.width * FLOOR_CHUNK_SIZE;
+    floor.tiles.assign((size_t) (floor.height * floor.width), Tile_t{});
+
+    for (FloorBits_t *bits : {&floor.perma_lit_room, &floor.field_mark, &floor.permanent_light, &floor.temporary_light}) {
+        bits->words_per_row = (floor.width + FLOOR_BITS_MASK) >> FLOOR_BITS_SHIFT;
+        bits->words.assign((size_t) (floor.height * bits->words_per_row), 0);
+    }
+
+    floor.region_ids.assign((size_t) (floor.height * floor.width), 0);
+    dg.regions.clear();
+}
+
+// Blanks out every tile of the floor, along with its flags.
+void dungeonClearFloor() {
+    Floor_t &floor = dg.floor;
+
+    memset((char *) floor.tiles.data(), 0, floor.tiles.size() * sizeof(Tile_t));
+
+    for (FloorBits_t *bits : {&floor.perma_lit_room, &floor.field_mark, &floor.permanent_light, &floor.temporary_light}) {
+        memset((char *) bits->words.data(), 0, bits->words.size() * sizeof(uint64_t));
+    }
+
+    memset((char *) floor.region_ids.data(), 0, floor.region_ids.size() * sizeof(uint16_t));
+    dg.regions.clear();
+}
+
+// The bits of the given word which are for the tiles from `left` to `right`.
+uint64_t floorBitsMask(int word, int left, int right) {
+    int first = word << FLOOR_BITS_SHIFT;
+    int last = first + FLOOR_BITS_MASK;
+
+    if (right < first || left > last) {
+        return 0;
+    }
+
+    uint64_t mask = ~(uint64_t) 0;
+    if (left > first) {
+        mask &= ~(uint64_t) 0 << (left - first);
+    }
+    if (right < last) {
+        mask &= ~(uint64_t) 0 >> (last - right);
+    }
+
+    return mask;
+}
+
+// Position of the lowest bit set, which must not be zero.
+int floorBitsLowest(uint64_t bits) {
+    return __builtin_ctzll(bits);
+}
+
+// Position of the highest bit set, which must not be zero.
+int floorBitsHighest(uint64_t bits) {
+    return FLOOR_BITS_MASK - __builtin_clzll(bits);
+}
+
+void floorBitsSetRange(FloorBits_t &bits, int y, int left, int right) {
+    uint64_t *row = bits.row(y);
+
+    for (int word = left >> FLOOR_BITS_SHIFT; word <= right >> FLOOR_BITS_SHIFT; word++) {
+        row[word] |= floorBitsMask(word, left, right);
+    }
+}
+
+void floorBitsResetRange(FloorBits_t &bits, int y, int left, int right) {
+    uint64_t *row = bits.row(y);
+
+    for (int word = left >> FLOOR_BITS_SHIFT; word <= right >> FLOOR_BITS_SHIFT; word++) {
+        row[word] &= ~floorBitsMask(word, left, right);
+    }
+}
 
 // dungeonDisplayMap shrinks the dungeon to a single screen
 void dungeonDisplayMap() {
@@ -29,12 +116,13 @@ void dungeonDisplayMap() {
     priority[92] = -3;   // char '\'
     priority[32] = -15;  // char ' '
 
-    // Display highest priority object in the RATIO, by RATIO area
-    constexpr uint8_t RATIO = 3;
-    uint8_t panel_width = MAX_WIDTH / RATIO;
-    uint8_t panel_height = MAX_HEIGHT / RATIO;
+    // Display highest priority object in each ratio by ratio area,
+    // which is larger on the larger dungeons so the map still fits.
+    int ratio = 3 * dg.scale;
+    uint8_t panel_width = DUNGEON_WIDTH / 3;
+    uint8_t panel_height = DUNGEON_HEIGHT / 3;
 
-    char map[MAX_WIDTH / RATIO + 1] = {'\0'};
+    char map[DUNGEON_WIDTH / 3 + 1] = {'\0'};
     char line_buffer[80];
 
     // Add screen border
@@ -57,8 +145,8 @@ void dungeonDisplayMap() {
     int line = -1;
 
     // Shrink the dungeon!
-    for (uint8_t y = 0; y < MAX_HEIGHT; y++) {
-        uint8_t row = y / RATIO;
+    for (int y = 0; y < DUNGEON_HEIGHT * dg.scale; y++) {
+        int row = y / ratio;
         if (row != line) {
             if (line >= 0) {
                 sprintf(line_buffer, "|%s|", map);
@@ -70,8 +158,8 @@ void dungeonDisplayMap() {
             line = row;
         }
 
-        for (uint8_t x = 0; x < MAX_WIDTH; x++) {
-            uint8_t col = x / RATIO;
+        for (int x = 0; x < DUNGEON_WIDTH * dg.scale; x++) {
+            int col = x / ratio;
             char cave_char = caveGetTileSymbol(Coord_t{y, x});
             if (priority[(uint8_t) map[col]] < priority[(uint8_t) cave_char]) {
                 map[col] = cave_char;
@@ -191,7 +279,7 @@ char caveGetTileSymbol(Coord_t const &coord) {
         return creatures_list[monsters[tile.creature_id].creature_id].sprite;
     }
 
-    if (!tile.permanent_light && !tile.temporary_light && !tile.field_mark) {
+    if (!caveTileVisible(coord)) {
         return ' ';
     }
 
@@ -214,20 +302,20 @@ char caveGetTileSymbol(Coord_t const &coord) {
 
 // Tests a spot for light or field mark status -RAK-
 bool caveTileVisible(Coord_t const &coord) {
-    return dg.floor[coord.y][coord.x].permanent_light || dg.floor[coord.y][coord.x].temporary_light || dg.floor[coord.y][coord.x].field_mark;
+    return dg.floor.permanent_light.test(coord.y, coord.x) || dg.floor.temporary_light.test(coord.y, coord.x) || dg.floor.field_mark.test(coord.y, coord.x);
 }
 
 // Places a particular trap at location y, x -RAK-
 void dungeonSetTrap(Coord_t const &coord, int sub_type_id) {
     int free_treasure_id = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
+    dungeonPlaceTreasure(Coord_t{coord.y, coord.x}, free_treasure_id);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_TRAP_LIST + sub_type_id, treasure_list[free_treasure_id]);
 }
 
 // Change a trap from invisible to visible -RAK-
 // Note: Secret doors are handled here
 void trapChangeVisibility(Coord_t const &coord) {
-    uint8_t treasure_id = dg.floor[coord.y][coord.x].treasure_id;
+    uint16_t treasure_id = dg.floor[coord.y][coord.x].treasure_id;
 
     Inventory_t &item = treasure_list[treasure_id];
 
@@ -249,8 +337,8 @@ void trapChangeVisibility(Coord_t const &coord) {
 // Places rubble at location y, x -RAK-
 void dungeonPlaceRubble(Coord_t const &coord) {
     int free_treasure_id = popt();
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
-    dg.floor[coord.y][coord.x].feature_id = TILE_BLOCKED_FLOOR;
+    dungeonPlaceTreasure(Coord_t{coord.y, coord.x}, free_treasure_id);
+    dungeonSetTileFeature(dg.floor[coord.y][coord.x], TILE_BLOCKED_FLOOR);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_RUBBLE, treasure_list[free_treasure_id]);
 }
 
@@ -268,7 +356,7 @@ void dungeonPlaceGold(Coord_t const &coord) {
         gold_type_id = config::dungeon::objects::MAX_GOLD_TYPES - 1;
     }
 
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
+    dungeonPlaceTreasure(Coord_t{coord.y, coord.x}, free_treasure_id);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_GOLD_LIST + gold_type_id, treasure_list[free_treasure_id]);
     treasure_list[free_treasure_id].cost += (8L * (int32_t) randomNumber((int) treasure_list[free_treasure_id].cost)) + randomNumber(8);
 
@@ -281,7 +369,7 @@ void dungeonPlaceGold(Coord_t const &coord) {
 void dungeonPlaceRandomObjectAt(Coord_t const &coord, bool must_be_small) {
     int free_treasure_id = popt();
 
-    dg.floor[coord.y][coord.x].treasure_id = (uint8_t) free_treasure_id;
+    dungeonPlaceTreasure(Coord_t{coord.y, coord.x}, free_treasure_id);
 
     int object_id = itemGetRandomObjectId(dg.current_level, must_be_small);
     inventoryItemCopyTo(sorted_objects[object_id], treasure_list[free_treasure_id]);
@@ -350,38 +438,133 @@ void dungeonPlaceRandomObjectNear(Coord_t coord, int tries) {
     } while (tries != 0);
 }
 
+// Changes what is on the tile. Once the level has been generated, any change
+// which could block or unblock the line of sight must be made here, so the
+// los() results can be thrown away.
+void dungeonSetTileFeature(Tile_t &tile, uint8_t feature_id) {
+    if ((tile.feature_id >= MIN_CLOSED_SPACE) != (feature_id >= MIN_CLOSED_SPACE)) {
+        losCacheInvalidate();
+    }
+
+    tile.feature_id = feature_id;
+}
+
 // Moves creature record from one space to another -RAK-
 // this always works correctly, even if y1==y2 and x1==x2
 void dungeonMoveCreatureRecord(Coord_t const &from, Coord_t const &to) {
     int id = dg.floor[from.y][from.x].creature_id;
+    if (id >= config::monsters::MON_MIN_INDEX_ID) {
+        monsterIndexMove(id, from, to);
+    }
+
     dg.floor[from.y][from.x].creature_id = 0;
-    dg.floor[to.y][to.x].creature_id = (uint8_t) id;
+    dg.floor[to.y][to.x].creature_id = (uint16_t) id;
 }
 
-// Room is lit, make it appear -RAK-
-void dungeonLightRoom(Coord_t const &coord) {
+// Gives the room tiles in one block of the dungeon the next region id.
+// Rooms are built in the middle of their block, so each block holds
+// the tiles of one room at most.
+static void dungeonLabelBlock(int top, int left, int bottom, int right) {
+    Region_t region = Region_t{Coord_t{-1, -1}, Coord_t{-1, -1}};
+
+    for (int y = top; y <= bottom; y++) {
+        uint64_t const *room = dg.floor.perma_lit_room.row(y);
+
+        for (int word = left >> FLOOR_BITS_SHIFT; word <= right >> FLOOR_BITS_SHIFT; word++) {
+            uint64_t bits = room[word] & floorBitsMask(word, left, right);
+            if (bits == 0) {
+                continue;
+            }
+
+            int first = (word << FLOOR_BITS_SHIFT) + floorBitsLowest(bits);
+            int last = (word << FLOOR_BITS_SHIFT) + floorBitsHighest(bits);
+
+            if (region.top_left.y < 0) {
+                region = Region_t{Coord_t{y, first}, Coord_t{y, last}};
+            }
+            if (first < region.top_left.x) {
+                region.top_left.x = first;
+            }
+            if (last > region.bottom_right.x) {
+                region.bottom_right.x = last;
+            }
+            region.bottom_right.y = y;
+        }
+    }
+
+    if (region.top_left.y < 0) {
+        return;
+    }
+
+    dg.regions.push_back(region);
+    auto id = (uint16_t) dg.regions.size();
+
+    for (int y = region.top_left.y; y <= region.bottom_right.y; y++) {
+        for (int x = region.top_left.x; x <= region.bottom_right.x; x++) {
+            if (dg.floor.perma_lit_room.test(y, x)) {
+                dg.floor.region_ids[(size_t) (y * dg.floor.width + x)] = id;
+            }
+        }
+    }
+}
+
+// Labels the rooms of the level, after it is made or loaded.
+void dungeonLabelRegions() {
     int height_middle = (SCREEN_HEIGHT / 2);
     int width_middle = (SCREEN_WIDTH / 2);
 
-    int top = (coord.y / height_middle) * height_middle;
-    int left = (coord.x / width_middle) * width_middle;
-    int bottom = top + height_middle - 1;
-    int right = left + width_middle - 1;
+    memset((char *) dg.floor.region_ids.data(), 0, dg.floor.region_ids.size() * sizeof(uint16_t));
+    dg.regions.clear();
+
+    for (int top = 0; top < dg.height; top += height_middle) {
+        for (int left = 0; left < dg.width; left += width_middle) {
+            dungeonLabelBlock(top, left, top + height_middle - 1, left + width_middle - 1);
+        }
+    }
+}
+
+// The room the tile is part of, if any.
+Region_t const *dungeonRegionAt(Coord_t const &coord) {
+    uint16_t id = dg.floor.region_ids[(size_t) (coord.y * dg.floor.width + coord.x)];
+    if (id == 0) {
+        return nullptr;
+    }
+
+    return &dg.regions[id - 1];
+}
+
+// Room is lit, make it appear -RAK-
+void dungeonLightRoom(Coord_t const &coord) {
+    Region_t const *region = dungeonRegionAt(coord);
+    if (region == nullptr) {
+        return;
+    }
+
+    int top = region->top_left.y;
+    int left = region->top_left.x;
+    int bottom = region->bottom_right.y;
+    int right = region->bottom_right.x;
 
     for (int y = top; y <= bottom; y++) {
-        for (int x = left; x <= right; x++) {
-            Tile_t &tile = dg.floor[y][x];
+        uint64_t const *room = dg.floor.perma_lit_room.row(y);
+        uint64_t *lit = dg.floor.permanent_light.row(y);
+
+        // only the room tiles which are not yet lit
+        for (int word = left >> FLOOR_BITS_SHIFT; word <= right >> FLOOR_BITS_SHIFT; word++) {
+            uint64_t unlit = room[word] & ~lit[word] & floorBitsMask(word, left, right);
+            lit[word] |= unlit;
 
-            if (tile.perma_lit_room && !tile.permanent_light) {
-                tile.permanent_light = true;
+            for (; unlit != 0; unlit &= unlit - 1) {
+                int x = (word << FLOOR_BITS_SHIFT) + floorBitsLowest(unlit);
+                Tile_t &tile = dg.floor[y][x];
 
                 if (tile.feature_id == TILE_DARK_FLOOR) {
                     tile.feature_id = TILE_LIGHT_FLOOR;
                 }
-                if (!tile.field_mark && tile.treasure_id != 0) {
+                if (!dg.floor.field_mark.test(y, x) && tile.treasure_id != 0) {
                     int treasure_id = treasure_list[tile.treasure_id].category_id;
                     if (treasure_id >= TV_MIN_VISIBLE && treasure_id <= TV_MAX_VISIBLE) {
-                        tile.field_mark = true;
+                        dg.floor.field_mark.set(y, x);
                     }
                 }
                 panelPutTile(caveGetTileSymbol(Coord_t{y, x}), Coord_t{y, x});
@@ -406,9 +589,7 @@ static void sub1_move_light(Coord_t const &from, Coord_t const &to) {
     if (py.temporary_light_only) {
         // Turn off lamp light
         for (int y = from.y - 1; y <= from.y + 1; y++) {
-            for (int x = from.x - 1; x <= from.x + 1; x++) {
-                dg.floor[y][x].temporary_light = false;
-            }
+            floorBitsResetRange(dg.floor.temporary_light, y, from.x - 1, from.x + 1);
         }
         if ((py.running_tracker != 0) && !config::options::run_print_self) {
             py.temporary_light_only = false;
@@ -418,21 +599,21 @@ static void sub1_move_light(Coord_t const &from, Coord_t const &to) {
     }
 
     for (int y = to.y - 1; y <= to.y + 1; y++) {
-        for (int x = to.x - 1; x <= to.x + 1; x++) {
-            Tile_t &tile = dg.floor[y][x];
+        // only light up if normal movement
+        if (py.temporary_light_only) {
+            floorBitsSetRange(dg.floor.temporary_light, y, to.x - 1, to.x + 1);
+        }
 
-            // only light up if normal movement
-            if (py.temporary_light_only) {
-                tile.temporary_light = true;
-            }
+        for (int x = to.x - 1; x <= to.x + 1; x++) {
+            Tile_t const &tile = dg.floor[y][x];
 
             if (tile.feature_id >= MIN_CAVE_WALL) {
-                tile.permanent_light = true;
-            } else if (!tile.field_mark && tile.treasure_id != 0) {
+                dg.floor.permanent_light.set(y, x);
+            } else if (!dg.floor.field_mark.test(y, x) && tile.treasure_id != 0) {
                 int tval = treasure_list[tile.treasure_id].category_id;
 
                 if (tval >= TV_MIN_VISIBLE && tval <= TV_MAX_VISIBLE) {
-                    tile.field_mark = true;
+                    dg.floor.field_mark.set(y, x);
                 }
             }
         }
@@ -469,8 +650,9 @@ static void sub1_move_light(Coord_t const &from, Coord_t const &to) {
 static void sub3_move_light(Coord_t const &from, Coord_t const &to) {
     if (py.temporary_light_only) {
         for (int y = from.y - 1; y <= from.y + 1; y++) {
+            floorBitsResetRange(dg.floor.temporary_light, y, from.x - 1, from.x + 1);
+
             for (int x = from.x - 1; x <= from.x + 1; x++) {
-                dg.floor[y][x].temporary_light = false;
                 panelPutTile(caveGetTileSymbol(Coord_t{y, x}), Coord_t{y, x});
             }
         }
@@ -506,10 +688,11 @@ void dungeonDeleteMonster(int id) {
     }
 
     int last_id = next_free_monster_id - 1;
+    monsterIndexDelete(id, last_id);
 
     if (id != last_id) {
         monster = &monsters[last_id];
-        dg.floor[monster->y][monster->x].creature_id = (uint8_t) id;
+        dg.floor[monster->y][monster->x].creature_id = (uint16_t) id;
         monsters[id] = monsters[last_id];
     }
 
@@ -553,11 +736,12 @@ void dungeonDeleteMonsterFix1(int id) {
 // by fix1_monster_delete above, this is only called in updateMonsters()
 void dungeonDeleteMonsterFix2(int id) {
     int last_id = next_free_monster_id - 1;
+    monsterIndexDelete(id, last_id);
 
     if (id != last_id) {
         int y = monsters[last_id].y;
         int x = monsters[last_id].x;
-        dg.floor[y][x].creature_id = (uint8_t) id;
+        dg.floor[y][x].creature_id = (uint16_t) id;
 
         monsters[id] = monsters[last_id];
     }
@@ -624,13 +808,13 @@ bool dungeonDeleteObject(Coord_t const &coord) {
     Tile_t &tile = dg.floor[coord.y][coord.x];
 
     if (tile.feature_id == TILE_BLOCKED_FLOOR) {
-        tile.feature_id = TILE_CORR_FLOOR;
+        dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
     }
 
     pusht(tile.treasure_id);
 
     tile.treasure_id = 0;
-    tile.field_mark = false;
+    dg.floor.field_mark.reset(coord.y, coord.x);
 
     dungeonLiteSpot(coord);
 
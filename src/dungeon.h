@@ -8,9 +8,13 @@
 
 #pragma once
 
-// Dungeon size parameters
-constexpr uint8_t MAX_HEIGHT = 66; // Multiple of 11; >= 22
-constexpr uint8_t MAX_WIDTH = 198; // Multiple of 33; >= 66
+// Dungeon size parameters, for a normal sized dungeon level.
+// Larger levels are a multiple of these, given by the dungeon scale.
+constexpr uint8_t DUNGEON_HEIGHT = 66; // Multiple of 11; >= 22
+constexpr uint8_t DUNGEON_WIDTH = 198; // Multiple of 33; >= 66
+constexpr uint8_t DUNGEON_SCALE_MAX = 4;
+constexpr int16_t DUNGEON_HEIGHT_MAX = DUNGEON_HEIGHT * DUNGEON_SCALE_MAX;
+constexpr int16_t DUNGEON_WIDTH_MAX = DUNGEON_WIDTH * DUNGEON_SCALE_MAX;
 constexpr uint8_t SCREEN_HEIGHT = 22;
 constexpr uint8_t SCREEN_WIDTH = 66;
 constexpr uint8_t QUART_HEIGHT = (SCREEN_HEIGHT / 4);
@@ -37,11 +41,95 @@ typedef struct {
     uint8_t depth_first_found; // Dungeon level item first found
 } DungeonObject_t;
 
+// The floor tiles are stored in square chunks, rather than one long row after
+// another, so the tiles around any spot are close together in memory.
+// Tiles are still found with `dg.floor[y][x]`.
+constexpr uint8_t FLOOR_CHUNK_SHIFT = 4;
+constexpr uint8_t FLOOR_CHUNK_SIZE = 1 << FLOOR_CHUNK_SHIFT;
+constexpr uint8_t FLOOR_CHUNK_MASK = FLOOR_CHUNK_SIZE - 1;
+
+// One row of the floor, as returned by `dg.floor[y]`.
+typedef struct {
+    Tile_t *chunks; // First tile of the chunks holding this row
+    int offset;     // Where this row starts within each chunk
+
+    Tile_t &operator[](int x) const {
+        return chunks[((x >> FLOOR_CHUNK_SHIFT) << (2 * FLOOR_CHUNK_SHIFT)) + offset + (x & FLOOR_CHUNK_MASK)];
+    }
+} FloorRow_t;
+
+// One flag for each tile of the floor, kept as a bit per tile with every
+// row starting on a new word. Runs of tiles along a row can then be tested,
+// set or cleared a whole word at a time.
+constexpr uint8_t FLOOR_BITS_SHIFT = 6;
+constexpr uint8_t FLOOR_BITS_MASK = 63;
+
+typedef struct {
+    int words_per_row;
+    std::vector<uint64_t> words;
+
+    uint64_t *row(int y) {
+        return &words[(size_t) (y * words_per_row)];
+    }
+
+    uint64_t const *row(int y) const {
+        return &words[(size_t) (y * words_per_row)];
+    }
+
+    bool test(int y, int x) const {
+        return ((row(y)[x >> FLOOR_BITS_SHIFT] >> (x & FLOOR_BITS_MASK)) & 1u) != 0;
+    }
+
+    void set(int y, int x) {
+        row(y)[x >> FLOOR_BITS_SHIFT] |= (uint64_t) 1 << (x & FLOOR_BITS_MASK);
+    }
+
+    void reset(int y, int x) {
+        row(y)[x >> FLOOR_BITS_SHIFT] &= ~((uint64_t) 1 << (x & FLOOR_BITS_MASK));
+    }
+
+    void assign(int y, int x, bool value) {
+        if (value) {
+            set(y, x);
+        } else {
+            reset(y, x);
+        }
+    }
+} FloorBits_t;
+
+typedef struct {
+    int16_t height; // Allocated size, a multiple of FLOOR_CHUNK_SIZE
+    int16_t width;
+    int chunk_row_size; // Tiles in one row of chunks
+    std::vector<Tile_t> tiles;
+
+    FloorBits_t perma_lit_room;  // Room should be lit with perm light, walls with this set should be perm lit after tunneled out.
+    FloorBits_t field_mark;      // Field mark, used for traps/doors/stairs, object is hidden if fm is false.
+    FloorBits_t permanent_light; // Permanent light, used for walls and lighted rooms.
+    FloorBits_t temporary_light; // Temporary light, used for player's lamp light,etc.
+
+    std::vector<uint16_t> region_ids; // Room of each tile, row by row, 0 when not in a room
+
+    FloorRow_t operator[](int y) {
+        return FloorRow_t{&tiles[(size_t) ((y >> FLOOR_CHUNK_SHIFT) * chunk_row_size)], (y & FLOOR_CHUNK_MASK) << FLOOR_CHUNK_SHIFT};
+    }
+} Floor_t;
+
+// A room of the level, the tiles of which are all lit and darkened together.
+// Rooms are labelled once the level is made, and again after loading a game.
+typedef struct {
+    Coord_t top_left; // Bounding box of the room tiles, walls included
+    Coord_t bottom_right;
+} Region_t;
+
 typedef struct {
     // Dungeon size is either just big enough for town level, or the whole dungeon itself
     int16_t height;
     int16_t width;
 
+    // Dungeon levels are `scale` times the normal height and width
+    uint8_t scale;
+
     Panel_t panel;
 
     // Current turn of the game
@@ -54,12 +142,23 @@ typedef struct {
     bool generate_new_level;
 
     // Floor definitions
-    Tile_t floor[MAX_HEIGHT][MAX_WIDTH];
+    Floor_t floor;
+
+    // The rooms, where a `region_ids` value of `n` is `regions[n - 1]`
+    std::vector<Region_t> regions;
 } Dungeon_t;
 
 extern Dungeon_t dg;
 extern DungeonObject_t game_objects[MAX_OBJECTS_IN_GAME];
 
+void dungeonSetScale(int scale);
+void dungeonClearFloor();
+
+uint64_t floorBitsMask(int word, int left, int right);
+int floorBitsLowest(uint64_t bits);
+int floorBitsHighest(uint64_t bits);
+void floorBitsSetRange(FloorBits_t &bits, int y, int left, int right);
+void floorBitsResetRange(FloorBits_t &bits, int y, int left, int right);
 void dungeonDisplayMap();
 
 bool coordInBounds(Coord_t const &coord);
@@ -79,7 +178,10 @@ void dungeonPlaceRandomObjectAt(Coord_t const &coord, bool must_be_small);
 void dungeonAllocateAndPlaceObject(bool (*set_function)(int), int object_type, int number);
 void dungeonPlaceRandomObjectNear(Coord_t coord, int tries);
 
+void dungeonSetTileFeature(Tile_t &tile, uint8_t feature_id);
 void dungeonMoveCreatureRecord(Coord_t const &from, Coord_t const &to);
+void dungeonLabelRegions();
+Region_t const *dungeonRegionAt(Coord_t const &coord);
 void dungeonLightRoom(Coord_t const &coord);
 void dungeonLiteSpot(Coord_t const &coord);
 void dungeonMoveCharacterLight(Coord_t const &from, Coord_t const &to);
@@ -93,6 +195,14 @@ bool dungeonDeleteObject(Coord_t const &coord);
 // generate the dungeon
 void generateCave();
 
+// Player distance map, used for monster movement
+constexpr int FLOW_UNREACHED = -1;
+
+void dungeonFlowReset();
+void dungeonFlowUpdate();
+int dungeonFlowDistance(Coord_t const &coord);
+
 // Line of Sight
 bool los(int from_y, int from_x, int to_y, int to_x);
+void losCacheInvalidate();
 void look();
@@ -0,0 +1,118 @@
+// Copyright (c) 1981-86 Robert A. Koeneke
+// Copyright (c) 1987-94 James E. Wilson
+//
+// This work is free software released under the GNU General Public License
+// version 2.0, and comes with ABSOLUTELY NO WARRANTY.
+//
+// See LICENSE and AUTHORS for more information.
+
+// Distance map centred on the player, shared by all monsters chasing the player
+
+#include "headers.h"
+
+// Tiles further than this from the player are not mapped, and
+// monsters there just head straight for the player as before.
+constexpr uint8_t FLOW_MAX_DISTANCE = 32;
+
+// Doors being opened and walls tunnelled through are picked
+// up every few turns, even when the player does not move.
+constexpr int32_t FLOW_REFRESH_TURNS = 10;
+
+static uint8_t flow_distance[DUNGEON_HEIGHT_MAX][DUNGEON_WIDTH_MAX];
+
+// Tiles are only part of the map when their stamp matches the current one,
+// which saves clearing the whole map for every update.
+static uint16_t flow_stamp[DUNGEON_HEIGHT_MAX][DUNGEON_WIDTH_MAX];
+static uint16_t current_stamp = 0;
+
+static Coord_t flow_center = Coord_t{-1, -1};
+static int32_t flow_turn = 0;
+static bool flow_valid = false;
+
+// No more than this many tiles are within FLOW_MAX_DISTANCE steps.
+static Coord_t flow_queue[(2 * FLOW_MAX_DISTANCE + 1) * (2 * FLOW_MAX_DISTANCE + 1)];
+
+// The map no longer matches the dungeon, e.g. on a new level.
+void dungeonFlowReset() {
+    flow_valid = false;
+}
+
+// Monsters that don't go through walls can only walk on floors,
+// or through the doors and rubble found on blocked floors.
+static bool flowTileIsPassable(Tile_t const &tile) {
+    return tile.feature_id <= MAX_CAVE_FLOOR;
+}
+
+static void flowVisit(Coord_t const &coord, uint8_t distance, int &queue_end) {
+    flow_stamp[coord.y][coord.x] = current_stamp;
+    flow_distance[coord.y][coord.x] = distance;
+    flow_queue[queue_end++] = coord;
+}
+
+// Breadth first search out from the player, up to FLOW_MAX_DISTANCE steps.
+static void flowCreate() {
+    current_stamp++;
+
+    // The stamps have wrapped around, so old ones could match again.
+    if (current_stamp == 0) {
+        for (auto &row : flow_stamp) {
+            for (auto &stamp : row) {
+                stamp = 0;
+            }
+        }
+        current_stamp = 1;
+    }
+
+    int queue_start = 0;
+    int queue_end = 0;
+
+    flowVisit(Coord_t{py.row, py.col}, 0, queue_end);
+
+    while (queue_start < queue_end) {
+        Coord_t coord = flow_queue[queue_start++];
+
+        uint8_t distance = flow_distance[coord.y][coord.x];
+        if (distance >= FLOW_MAX_DISTANCE) {
+            continue;
+        }
+
+        for (int y = coord.y - 1; y <= coord.y + 1; y++) {
+            for (int x = coord.x - 1; x <= coord.x + 1; x++) {
+                if (y < 0 || x < 0 || y >= dg.height || x >= dg.width || flow_stamp[y][x] == current_stamp) {
+                    continue;
+                }
+
+                if (flowTileIsPassable(dg.floor[y][x])) {
+                    flowVisit(Coord_t{y, x}, (uint8_t) (distance + 1), queue_end);
+                }
+            }
+        }
+    }
+
+    flow_center = Coord_t{py.row, py.col};
+    flow_turn = dg.game_turn;
+    flow_valid = true;
+}
+
+// Bring the map up to date, which is only done when the player has moved,
+// or when it has not been refreshed for a few turns.
+void dungeonFlowUpdate() {
+    bool player_moved = flow_center.y != py.row || flow_center.x != py.col;
+    bool out_of_date = dg.game_turn < flow_turn || dg.game_turn - flow_turn >= FLOW_REFRESH_TURNS;
+
+    if (flow_valid && !player_moved && !out_of_date) {
+        return;
+    }
+
+    flowCreate();
+}
+
+// Number of steps to walk from the coord to the player,
+// or FLOW_UNREACHED when not on the map.
+int dungeonFlowDistance(Coord_t const &coord) {
+    if (!flow_valid || !coordInBounds(coord) || flow_stamp[coord.y][coord.x] != current_stamp) {
+        return FLOW_UNREACHED;
+    }
+
+    return flow_distance[coord.y][coord.x];
+}
@@ -10,7 +10,12 @@
 
 #include "headers.h"
 
-static Coord_t doors_tk[100];
+// Tunnels and doors are limited in length and number,
+// with the limits raised along with the dungeon scale.
+constexpr int TUNNEL_MAX_LENGTH = 1000;
+constexpr int DOORS_MAX = 100;
+
+static Coord_t doors_tk[DOORS_MAX * DUNGEON_SCALE_MAX * DUNGEON_SCALE_MAX];
 static int door_index;
 
 // Returns a Dark/Light floor tile based on dg.current_level, and random number
@@ -63,7 +68,7 @@ static void chanceOfRandomDirection(int &y, int &x) {
 
 // Blanks out entire cave -RAK-
 static void dungeonBlankEntireCave() {
-    memset((char *) &dg.floor[0][0], 0, sizeof(dg.floor));
+    dungeonClearFloor();
 }
 
 // Fills in empty spots with desired rock -RAK-
@@ -82,54 +87,26 @@ static void dungeonFillEmptyTilesWith(uint8_t rock_type) {
     }
 }
 
-#ifdef DEBUG
-#include <assert.h>
-#endif
-
 // Places indestructible rock around edges of dungeon -RAK-
 static void dungeonPlaceBoundaryWalls() {
-    Tile_t(*left_ptr)[MAX_WIDTH];
-    Tile_t(*right_ptr)[MAX_WIDTH];
-
     // put permanent wall on leftmost row and rightmost row
-    left_ptr = (Tile_t(*)[MAX_WIDTH]) &dg.floor[0][0];
-    right_ptr = (Tile_t(*)[MAX_WIDTH]) &dg.floor[0][dg.width - 1];
-
-    for (int i = 0; i < dg.height; i++) {
-#ifdef DEBUG
-        assert((Tile_t *)left_ptr == &floor[i][0]);
-        assert((Tile_t *)right_ptr == &floor[i][dg.width - 1]);
-#endif
-
-        ((Tile_t *) left_ptr)->feature_id = TILE_BOUNDARY_WALL;
-        left_ptr++;
-
-        ((Tile_t *) right_ptr)->feature_id = TILE_BOUNDARY_WALL;
-        right_ptr++;
+    for (int y = 0; y < dg.height; y++) {
+        dg.floor[y][0].feature_id = TILE_BOUNDARY_WALL;
+        dg.floor[y][dg.width - 1].feature_id = TILE_BOUNDARY_WALL;
     }
 
     // put permanent wall on top row and bottom row
-    Tile_t *top_ptr = &dg.floor[0][0];
-    Tile_t *bottom_ptr = &dg.floor[dg.height - 1][0];
-
-    for (int i = 0; i < dg.width; i++) {
-#ifdef DEBUG
-        assert(top_ptr == &floor[0][i]);
-        assert(bottom_ptr == &floor[dg.height - 1][i]);
-#endif
-        top_ptr->feature_id = TILE_BOUNDARY_WALL;
-        top_ptr++;
-
-        bottom_ptr->feature_id = TILE_BOUNDARY_WALL;
-        bottom_ptr++;
+    for (int x = 0; x < dg.width; x++) {
+        dg.floor[0][x].feature_id = TILE_BOUNDARY_WALL;
+        dg.floor[dg.height - 1][x].feature_id = TILE_BOUNDARY_WALL;
     }
 }
 
 // Places "streamers" of rock through dungeon -RAK-
 static void dungeonPlaceStreamerRock(uint8_t rock_type, int chance_of_treasure) {
     // Choose starting point and direction
-    int pos_y = (dg.height / 2) + 11 - randomNumber(23);
-    int pos_x = (dg.width / 2) + 16 - randomNumber(33);
+    int pos_y = (dg.height / 2) + 11 * dg.scale - randomNumber(22 * dg.scale + 1);
+    int pos_x = (dg.width / 2) + 16 * dg.scale - randomNumber(32 * dg.scale + 1);
 
     // Get random direction. Numbers 1-4, 6-9
     int dir = randomNumber(8);
@@ -161,14 +138,14 @@ static void dungeonPlaceStreamerRock(uint8_t rock_type, int chance_of_treasure)
 
 static void dungeonPlaceOpenDoor(int y, int x) {
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{y, x}, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_OPEN_DOOR, treasure_list[cur_pos]);
     dg.floor[y][x].feature_id = TILE_CORR_FLOOR;
 }
 
 static void dungeonPlaceBrokenDoor(int y, int x) {
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{y, x}, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_OPEN_DOOR, treasure_list[cur_pos]);
     dg.floor[y][x].feature_id = TILE_CORR_FLOOR;
     treasure_list[cur_pos].misc_use = 1;
@@ -176,14 +153,14 @@ static void dungeonPlaceBrokenDoor(int y, int x) {
 
 static void dungeonPlaceClosedDoor(int y, int x) {
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{y, x}, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, treasure_list[cur_pos]);
     dg.floor[y][x].feature_id = TILE_BLOCKED_FLOOR;
 }
 
 static void dungeonPlaceLockedDoor(int y, int x) {
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{y, x}, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, treasure_list[cur_pos]);
     dg.floor[y][x].feature_id = TILE_BLOCKED_FLOOR;
     treasure_list[cur_pos].misc_use = (int16_t) (randomNumber(10) + 10);
@@ -191,7 +168,7 @@ static void dungeonPlaceLockedDoor(int y, int x) {
 
 static void dungeonPlaceStuckDoor(int y, int x) {
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{y, x}, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, treasure_list[cur_pos]);
     dg.floor[y][x].feature_id = TILE_BLOCKED_FLOOR;
     treasure_list[cur_pos].misc_use = (int16_t) (-randomNumber(10) - 10);
@@ -199,7 +176,7 @@ static void dungeonPlaceStuckDoor(int y, int x) {
 
 static void dungeonPlaceSecretDoor(int y, int x) {
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{y, x}, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_SECRET_DOOR, treasure_list[cur_pos]);
     dg.floor[y][x].feature_id = TILE_BLOCKED_FLOOR;
 }
@@ -235,7 +212,7 @@ static void dungeonPlaceUpStairs(int y, int x) {
     }
 
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{y, x}, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_UP_STAIR, treasure_list[cur_pos]);
 }
 
@@ -246,12 +223,12 @@ static void dungeonPlaceDownStairs(int y, int x) {
     }
 
     int cur_pos = popt();
-    dg.floor[y][x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{y, x}, cur_pos);
     inventoryItemCopyTo(config::dungeon::objects::OBJ_DOWN_STAIR, treasure_list[cur_pos]);
 }
 
-// Places a staircase 1=up, 2=down -RAK-
-static void dungeonPlaceStairs(int stair_type, int number, int walls) {
+// Places a staircase 1=up, 2=down, at places picked from `rng` -RAK-
+static void dungeonPlaceStairs(Rng_t &rng, int stair_type, int number, int walls) {
     for (int i = 0; i < number; i++) {
         bool placed = false;
 
@@ -263,8 +240,8 @@ static void dungeonPlaceStairs(int stair_type, int number, int walls) {
                 // don't let y1/x1 be zero,
                 // don't let y2/x2 be equal to dg.height-1/dg.width-1,
                 // these values are always BOUNDARY_ROCK.
-                int y1 = randomNumber(dg.height - 14);
-                int x1 = randomNumber(dg.width - 14);
+                int y1 = rngRandomNumber(rng, dg.height - 14);
+                int x1 = rngRandomNumber(rng, dg.width - 14);
                 int y2 = y1 + 12;
                 int x2 = x1 + 12;
 
@@ -334,26 +311,27 @@ static void dungeonBuildRoom(int y, int x) {
     // so don't bother rewriting the y loop.
 
     for (int i = height; i <= depth; i++) {
+        floorBitsSetRange(dg.floor.perma_lit_room, i, left, right);
+
         for (int j = left; j <= right; j++) {
             dg.floor[i][j].feature_id = floor;
-            dg.floor[i][j].perma_lit_room = true;
         }
     }
 
     for (int i = height - 1; i <= depth + 1; i++) {
         dg.floor[i][left - 1].feature_id = TILE_GRANITE_WALL;
-        dg.floor[i][left - 1].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(i, left - 1);
 
         dg.floor[i][right + 1].feature_id = TILE_GRANITE_WALL;
-        dg.floor[i][right + 1].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(i, right + 1);
     }
 
     for (int i = left; i <= right; i++) {
         dg.floor[height - 1][i].feature_id = TILE_GRANITE_WALL;
-        dg.floor[height - 1][i].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(height - 1, i);
 
         dg.floor[depth + 1][i].feature_id = TILE_GRANITE_WALL;
-        dg.floor[depth + 1][i].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(depth + 1, i);
     }
 }
 
@@ -374,32 +352,33 @@ static void dungeonBuildRoomOverlappingRectangles(int y, int x) {
         // so don't bother rewriting the y loop.
 
         for (int i = height; i <= depth; i++) {
+            floorBitsSetRange(dg.floor.perma_lit_room, i, left, right);
+
             for (int j = left; j <= right; j++) {
                 dg.floor[i][j].feature_id = floor;
-                dg.floor[i][j].perma_lit_room = true;
             }
         }
         for (int i = (height - 1); i <= (depth + 1); i++) {
             if (dg.floor[i][left - 1].feature_id != floor) {
                 dg.floor[i][left - 1].feature_id = TILE_GRANITE_WALL;
-                dg.floor[i][left - 1].perma_lit_room = true;
+                dg.floor.perma_lit_room.set(i, left - 1);
             }
 
             if (dg.floor[i][right + 1].feature_id != floor) {
                 dg.floor[i][right + 1].feature_id = TILE_GRANITE_WALL;
-                dg.floor[i][right + 1].perma_lit_room = true;
+                dg.floor.perma_lit_room.set(i, right + 1);
             }
         }
 
         for (int i = left; i <= right; i++) {
             if (dg.floor[height - 1][i].feature_id != floor) {
                 dg.floor[height - 1][i].feature_id = TILE_GRANITE_WALL;
-                dg.floor[height - 1][i].perma_lit_room = true;
+                dg.floor.perma_lit_room.set(height - 1, i);
             }
 
             if (dg.floor[depth + 1][i].feature_id != floor) {
                 dg.floor[depth + 1][i].feature_id = TILE_GRANITE_WALL;
-                dg.floor[depth + 1][i].perma_lit_room = true;
+                dg.floor.perma_lit_room.set(depth + 1, i);
             }
         }
     }
@@ -534,26 +513,27 @@ static void dungeonBuildRoomWithInnerRooms(int y, int x) {
     // so don't bother rewriting the y loop.
 
     for (int i = height; i <= depth; i++) {
+        floorBitsSetRange(dg.floor.perma_lit_room, i, left, right);
+
         for (int j = left; j <= right; j++) {
             dg.floor[i][j].feature_id = floor;
-            dg.floor[i][j].perma_lit_room = true;
         }
     }
 
     for (int i = (height - 1); i <= (depth + 1); i++) {
         dg.floor[i][left - 1].feature_id = TILE_GRANITE_WALL;
-        dg.floor[i][left - 1].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(i, left - 1);
 
         dg.floor[i][right + 1].feature_id = TILE_GRANITE_WALL;
-        dg.floor[i][right + 1].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(i, right + 1);
     }
 
     for (int i = left; i <= right; i++) {
         dg.floor[height - 1][i].feature_id = TILE_GRANITE_WALL;
-        dg.floor[height - 1][i].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(height - 1, i);
 
         dg.floor[depth + 1][i].feature_id = TILE_GRANITE_WALL;
-        dg.floor[depth + 1][i].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(depth + 1, i);
     }
 
     // The inner room
@@ -674,26 +654,27 @@ static void dungeonBuildRoomCrossShaped(int y, int x) {
     int right = x + 1;
 
     for (int i = height; i <= depth; i++) {
+        floorBitsSetRange(dg.floor.perma_lit_room, i, left, right);
+
         for (int j = left; j <= right; j++) {
             dg.floor[i][j].feature_id = floor;
-            dg.floor[i][j].perma_lit_room = true;
         }
     }
 
     for (int i = height - 1; i <= depth + 1; i++) {
         dg.floor[i][left - 1].feature_id = TILE_GRANITE_WALL;
-        dg.floor[i][left - 1].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(i, left - 1);
 
         dg.floor[i][right + 1].feature_id = TILE_GRANITE_WALL;
-        dg.floor[i][right + 1].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(i, right + 1);
     }
 
     for (int i = left; i <= right; i++) {
         dg.floor[height - 1][i].feature_id = TILE_GRANITE_WALL;
-        dg.floor[height - 1][i].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(height - 1, i);
 
         dg.floor[depth + 1][i].feature_id = TILE_GRANITE_WALL;
-        dg.floor[depth + 1][i].perma_lit_room = true;
+        dg.floor.perma_lit_room.set(depth + 1, i);
     }
 
     random_offset = 2 + randomNumber(9);
@@ -704,33 +685,34 @@ static void dungeonBuildRoomCrossShaped(int y, int x) {
     right = x + random_offset;
 
     for (int i = height; i <= depth; i++) {
+        floorBitsSetRange(dg.floor.perma_lit_room, i, left, right);
+
         for (int j = left; j <= right; j++) {
             dg.floor[i][j].feature_id = floor;
-            dg.floor[i][j].perma_lit_room = true;
         }
     }
 
     for (int i = height - 1; i <= depth + 1; i++) {
         if (dg.floor[i][left - 1].feature_id != floor) {
             dg.floor[i][left - 1].feature_id = TILE_GRANITE_WALL;
-            dg.floor[i][left - 1].perma_lit_room = true;
+            dg.floor.perma_lit_room.set(i, left - 1);
         }
 
         if (dg.floor[i][right + 1].feature_id != floor) {
             dg.floor[i][right + 1].feature_id = TILE_GRANITE_WALL;
-            dg.floor[i][right + 1].perma_lit_room = true;
+            dg.floor.perma_lit_room.set(i, right + 1);
         }
     }
 
     for (int i = left; i <= right; i++) {
         if (dg.floor[height - 1][i].feature_id != floor) {
             dg.floor[height - 1][i].feature_id = TILE_GRANITE_WALL;
-            dg.floor[height - 1][i].perma_lit_room = true;
+            dg.floor.perma_lit_room.set(height - 1, i);
         }
 
         if (dg.floor[depth + 1][i].feature_id != floor) {
             dg.floor[depth + 1][i].feature_id = TILE_GRANITE_WALL;
-            dg.floor[depth + 1][i].perma_lit_room = true;
+            dg.floor.perma_lit_room.set(depth + 1, i);
         }
     }
 
@@ -795,7 +777,8 @@ static void dungeonBuildRoomCrossShaped(int y, int x) {
 
 // Constructs a tunnel between two points
 static void dungeonBuildTunnel(int y_start, int x_start, int y_end, int x_end) {
-    Coord_t tunnels_tk[1000], walls_tk[1000];
+    Coord_t tunnels_tk[TUNNEL_MAX_LENGTH * DUNGEON_SCALE_MAX], walls_tk[TUNNEL_MAX_LENGTH * DUNGEON_SCALE_MAX];
+    int max_length = TUNNEL_MAX_LENGTH * dg.scale;
 
     // Main procedure for Tunnel
     // Note: 9 is a temporary value
@@ -813,7 +796,7 @@ static void dungeonBuildTunnel(int y_start, int x_start, int y_end, int x_end) {
     do {
         // prevent infinite loops, just in case
         main_loop_count++;
-        if (main_loop_count > 2000) {
+        if (main_loop_count > 2 * max_length) {
             stop_flag = true;
         }
 
@@ -842,7 +825,7 @@ static void dungeonBuildTunnel(int y_start, int x_start, int y_end, int x_end) {
             case TILE_NULL_WALL:
                 y_start = tmp_row;
                 x_start = tmp_col;
-                if (tunnel_index < 1000) {
+                if (tunnel_index < max_length) {
                     tunnels_tk[tunnel_index].y = y_start;
                     tunnels_tk[tunnel_index].x = x_start;
                     tunnel_index++;
@@ -856,7 +839,7 @@ static void dungeonBuildTunnel(int y_start, int x_start, int y_end, int x_end) {
                 y_start = tmp_row;
                 x_start = tmp_col;
 
-                if (wall_index < 1000) {
+                if (wall_index < max_length) {
                     walls_tk[wall_index].y = y_start;
                     walls_tk[wall_index].x = x_start;
                     wall_index++;
@@ -880,7 +863,7 @@ static void dungeonBuildTunnel(int y_start, int x_start, int y_end, int x_end) {
                 x_start = tmp_col;
 
                 if (!door_flag) {
-                    if (door_index < 100) {
+                    if (door_index < DOORS_MAX * dg.scale * dg.scale) {
                         doors_tk[door_index].y = y_start;
                         doors_tk[door_index].x = x_start;
                         door_index++;
@@ -979,25 +962,31 @@ static bool setFloors(int tile_id) {
 
 // Cave logic flow for generation of new dungeon
 static void dungeonGenerate() {
+    // The larger dungeons get more of everything, in proportion to their area
+    int area = dg.scale * dg.scale;
+
     // Room initialization
     int row_rooms = 2 * (dg.height / SCREEN_HEIGHT);
     int col_rooms = 2 * (dg.width / SCREEN_WIDTH);
 
-    bool room_map[20][20];
+    constexpr int ROOM_ROWS_MAX = 2 * (DUNGEON_HEIGHT_MAX / SCREEN_HEIGHT);
+    constexpr int ROOM_COLS_MAX = 2 * (DUNGEON_WIDTH_MAX / SCREEN_WIDTH);
+
+    bool room_map[ROOM_ROWS_MAX][ROOM_COLS_MAX];
     for (int row = 0; row < row_rooms; row++) {
         for (int col = 0; col < col_rooms; col++) {
             room_map[row][col] = false;
         }
     }
 
-    int random_room_count = randomNumberNormalDistribution(config::dungeon::DUN_ROOMS_MEAN, 2);
+    int random_room_count = randomNumberNormalDistribution(config::dungeon::DUN_ROOMS_MEAN * area, 2 * dg.scale);
     for (int i = 0; i < random_room_count; i++) {
         room_map[randomNumber(row_rooms) - 1][randomNumber(col_rooms) - 1] = true;
     }
 
     // Build rooms
     int location_id = 0;
-    int16_t y_locations[400], x_locations[400];
+    int16_t y_locations[ROOM_ROWS_MAX * ROOM_COLS_MAX + 1], x_locations[ROOM_ROWS_MAX * ROOM_COLS_MAX + 1];
 
     for (int row = 0; row < row_rooms; row++) {
         for (int col = 0; col < col_rooms; col++) {
@@ -1049,10 +1038,10 @@ static void dungeonGenerate() {
 
     // Generate walls and streamers
     dungeonFillEmptyTilesWith(TILE_GRANITE_WALL);
-    for (int i = 0; i < config::dungeon::DUN_MAGMA_STREAMER; i++) {
+    for (int i = 0; i < config::dungeon::DUN_MAGMA_STREAMER * area; i++) {
         dungeonPlaceStreamerRock(TILE_MAGMA_WALL, config::dungeon::DUN_MAGMA_TREASURE);
     }
-    for (int i = 0; i < config::dungeon::DUN_QUARTZ_STREAMER; i++) {
+    for (int i = 0; i < config::dungeon::DUN_QUARTZ_STREAMER * area; i++) {
         dungeonPlaceStreamerRock(TILE_QUARTZ_WALL, config::dungeon::DUN_QUARTZ_TREASURE);
     }
     dungeonPlaceBoundaryWalls();
@@ -1072,18 +1061,18 @@ static void dungeonGenerate() {
         alloc_level = 10;
     }
 
-    dungeonPlaceStairs(2, randomNumber(2) + 2, 3);
-    dungeonPlaceStairs(1, randomNumber(2), 3);
+    dungeonPlaceStairs(rndStream(), 2, (randomNumber(2) + 2) * area, 3);
+    dungeonPlaceStairs(rndStream(), 1, randomNumber(2) * area, 3);
 
     // Set up the character coords, used by monsterPlaceNewWithinDistance, monsterPlaceWinning
     dungeonNewSpot(py.row, py.col);
 
-    monsterPlaceNewWithinDistance((randomNumber(8) + config::monsters::MON_MIN_PER_LEVEL + alloc_level), 0, true);
-    dungeonAllocateAndPlaceObject(setCorridors, 3, randomNumber(alloc_level));
-    dungeonAllocateAndPlaceObject(setRooms, 5, randomNumberNormalDistribution(config::dungeon::objects::LEVEL_OBJECTS_PER_ROOM, 3));
-    dungeonAllocateAndPlaceObject(setFloors, 5, randomNumberNormalDistribution(config::dungeon::objects::LEVEL_OBJECTS_PER_CORRIDOR, 3));
-    dungeonAllocateAndPlaceObject(setFloors, 4, randomNumberNormalDistribution(config::dungeon::objects::LEVEL_TOTAL_GOLD_AND_GEMS, 3));
-    dungeonAllocateAndPlaceObject(setFloors, 1, randomNumber(alloc_level));
+    monsterPlaceNewWithinDistance((randomNumber(8) + config::monsters::MON_MIN_PER_LEVEL + alloc_level) * area, 0, true);
+    dungeonAllocateAndPlaceObject(setCorridors, 3, randomNumber(alloc_level) * area);
+    dungeonAllocateAndPlaceObject(setRooms, 5, randomNumberNormalDistribution(config::dungeon::objects::LEVEL_OBJECTS_PER_ROOM, 3) * area);
+    dungeonAllocateAndPlaceObject(setFloors, 5, randomNumberNormalDistribution(config::dungeon::objects::LEVEL_OBJECTS_PER_CORRIDOR, 3) * area);
+    dungeonAllocateAndPlaceObject(setFloors, 4, randomNumberNormalDistribution(config::dungeon::objects::LEVEL_TOTAL_GOLD_AND_GEMS, 3) * area);
+    dungeonAllocateAndPlaceObject(setFloors, 1, randomNumber(alloc_level) * area);
 
     if (dg.current_level >= config::monsters::MON_ENDGAME_LEVEL) {
         monsterPlaceWinning();
@@ -1091,13 +1080,13 @@ static void dungeonGenerate() {
 }
 
 // Builds a store at a row, column coordinate
-static void dungeonBuildStore(int store_id, int y, int x) {
+static void dungeonBuildStore(Rng_t &rng, int store_id, int y, int x) {
     int yval = y * 10 + 5;
     int xval = x * 16 + 16;
-    int y_height = yval - randomNumber(3);
-    int y_depth = yval + randomNumber(4);
-    int x_left = xval - randomNumber(6);
-    int x_right = xval + randomNumber(6);
+    int y_height = yval - rngRandomNumber(rng, 3);
+    int y_depth = yval + rngRandomNumber(rng, 4);
+    int x_left = xval - rngRandomNumber(rng, 6);
+    int x_right = xval + rngRandomNumber(rng, 6);
 
     int pos_y, pos_x;
 
@@ -1107,9 +1096,9 @@ static void dungeonBuildStore(int store_id, int y, int x) {
         }
     }
 
-    int tmp = randomNumber(4);
+    int tmp = rngRandomNumber(rng, 4);
     if (tmp < 3) {
-        pos_y = randomNumber(y_depth - y_height) + y_height - 1;
+        pos_y = rngRandomNumber(rng, y_depth - y_height) + y_height - 1;
 
         if (tmp == 1) {
             pos_x = x_left;
@@ -1117,7 +1106,7 @@ static void dungeonBuildStore(int store_id, int y, int x) {
             pos_x = x_right;
         }
     } else {
-        pos_x = randomNumber(x_right - x_left) + x_left - 1;
+        pos_x = rngRandomNumber(rng, x_right - x_left) + x_left - 1;
 
         if (tmp == 3) {
             pos_y = y_depth;
@@ -1129,7 +1118,7 @@ static void dungeonBuildStore(int store_id, int y, int x) {
     dg.floor[pos_y][pos_x].feature_id = TILE_CORR_FLOOR;
 
     int cur_pos = popt();
-    dg.floor[pos_y][pos_x].treasure_id = (uint8_t) cur_pos;
+    dungeonPlaceTreasure(Coord_t{pos_y, pos_x}, cur_pos);
 
     inventoryItemCopyTo(config::dungeon::objects::OBJ_STORE_DOOR + store_id, treasure_list[cur_pos]);
 }
@@ -1148,9 +1137,10 @@ static void monsterLinker() {
         monster = blank_monster;
     }
     next_free_monster_id = config::monsters::MON_MIN_INDEX_ID;
+    monsterIndexClear();
 }
 
-static void dungeonPlaceTownStores() {
+static void dungeonPlaceTownStores(Rng_t &rng) {
     int rooms[6];
     for (int i = 0; i < 6; i++) {
         rooms[i] = i;
@@ -1160,8 +1150,8 @@ static void dungeonPlaceTownStores() {
 
     for (int y = 0; y < 2; y++) {
         for (int x = 0; x < 3; x++) {
-            int room_id = randomNumber(rooms_count) - 1;
-            dungeonBuildStore(rooms[room_id], y, x);
+            int room_id = rngRandomNumber(rng, rooms_count) - 1;
+            dungeonBuildStore(rng, rooms[room_id], y, x);
 
             for (int i = room_id; i < rooms_count - 1; i++) {
                 rooms[i] = rooms[i + 1];
@@ -1182,7 +1172,7 @@ static void lightTown() {
         for (int y = 0; y < dg.height; y++) {
             for (int x = 0; x < dg.width; x++) {
                 if (dg.floor[y][x].feature_id != TILE_DARK_FLOOR) {
-                    dg.floor[y][x].permanent_light = true;
+                    dg.floor.permanent_light.set(y, x);
                 }
             }
         }
@@ -1190,9 +1180,7 @@ static void lightTown() {
     } else {
         // ...it is day time
         for (int y = 0; y < dg.height; y++) {
-            for (int x = 0; x < dg.width; x++) {
-                dg.floor[y][x].permanent_light = true;
-            }
+            floorBitsSetRange(dg.floor.permanent_light, y, 0, dg.width - 1);
         }
         monsterPlaceNewWithinDistance(config::monsters::MON_MIN_TOWNSFOLK_DAY, 3, true);
     }
@@ -1204,24 +1192,24 @@ static void lightTown() {
 
 // Town logic flow for generation of new town
 static void townGeneration() {
-    seedSet(game.town_seed);
+    // The town is laid out the same on every visit, from its own stream
+    Rng_t town_rng;
+    rngSetSeed(town_rng, game.town_seed);
 
-    dungeonPlaceTownStores();
+    dungeonPlaceTownStores(town_rng);
 
     dungeonFillEmptyTilesWith(TILE_DARK_FLOOR);
 
-    // make stairs before seedResetToOldSeed, so that they don't move around
+    // make stairs from the town stream too, so that they don't move around
     dungeonPlaceBoundaryWalls();
-    dungeonPlaceStairs(2, 1, 0);
-
-    seedResetToOldSeed();
+    dungeonPlaceStairs(town_rng, 2, 1, 0);
 
     // Set up the character coords, used by monsterPlaceNewWithinDistance below
     dungeonNewSpot(py.row, py.col);
 
     lightTown();
 
-    storeMaintenance();
+    storeMaintenanceDue();
 }
 
 // Generates a random dungeon level -RAK-
@@ -1237,10 +1225,12 @@ void generateCave() {
     treasureLinker();
     monsterLinker();
     dungeonBlankEntireCave();
+    dungeonFlowReset();
+    losCacheInvalidate();
 
     // We're in the dungeon more than the town, so let's default to that -MRC-
-    dg.height = MAX_HEIGHT;
-    dg.width = MAX_WIDTH;
+    dg.height = (int16_t) (DUNGEON_HEIGHT * dg.scale);
+    dg.width = (int16_t) (DUNGEON_WIDTH * dg.scale);
 
     if (dg.current_level == 0) {
         dg.height = SCREEN_HEIGHT;
@@ -1258,4 +1248,6 @@ void generateCave() {
     } else {
         dungeonGenerate();
     }
+
+    dungeonLabelRegions();
 }
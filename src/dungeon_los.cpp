@@ -25,7 +25,7 @@
 
 // Because this function uses (short) ints for all calculations, overflow may
 // occur if deltaX and deltaY exceed 90.
-bool los(int from_y, int from_x, int to_y, int to_x) {
+static bool losTrace(int from_y, int from_x, int to_y, int to_x) {
     int delta_x = to_x - from_x;
     int delta_y = to_y - from_y;
 
@@ -178,6 +178,99 @@ bool los(int from_y, int from_x, int to_y, int to_x) {
     }
 }
 
+// los() is mostly called from the same few places over and over, such as
+// from the player to each monster, or from the centre of a ball spell, so
+// the results are kept for the most recent source tiles. Each source holds
+// bitsets for the tiles around it, one bit to say the result is known, and
+// one for the result itself.
+//
+// The results only depend on which tiles are see through, so they are all
+// thrown away when a tile changes between see through and blocking.
+constexpr int LOS_CACHE_RADIUS = 31;
+constexpr int LOS_CACHE_SIZE = LOS_CACHE_RADIUS * 2 + 1;
+constexpr int LOS_CACHE_SOURCES = 4;
+
+typedef struct {
+    Coord_t source;
+    uint32_t generation;
+    uint32_t last_used;
+    uint64_t known[LOS_CACHE_SIZE];
+    uint64_t visible[LOS_CACHE_SIZE];
+} LosCache_t;
+
+static LosCache_t los_cache[LOS_CACHE_SOURCES];
+
+// Generation 0 is never valid, so the empty cache is never used.
+static uint32_t los_cache_generation = 1;
+static uint32_t los_cache_clock = 0;
+
+// A source only gets cached the second time in a row it is missed, so
+// one-off sources don't push out the ones being used over and over.
+static Coord_t los_cache_candidate = Coord_t{-1, -1};
+
+// Throw away all the cached los() results.
+void losCacheInvalidate() {
+    los_cache_generation++;
+}
+
+// Returns the cache for the source tile, or nullptr when not cached.
+static LosCache_t *losCacheForSource(int y, int x) {
+    LosCache_t *oldest = &los_cache[0];
+
+    for (auto &cache : los_cache) {
+        if (cache.generation == los_cache_generation && cache.source.y == y && cache.source.x == x) {
+            cache.last_used = ++los_cache_clock;
+            return &cache;
+        }
+
+        if (cache.generation != los_cache_generation || cache.last_used < oldest->last_used) {
+            oldest = &cache;
+        }
+    }
+
+    if (los_cache_candidate.y != y || los_cache_candidate.x != x) {
+        los_cache_candidate = Coord_t{y, x};
+        return nullptr;
+    }
+
+    oldest->source = Coord_t{y, x};
+    oldest->generation = los_cache_generation;
+    oldest->last_used = ++los_cache_clock;
+    for (auto &bits : oldest->known) {
+        bits = 0;
+    }
+
+    return oldest;
+}
+
+bool los(int from_y, int from_x, int to_y, int to_x) {
+    int row = to_y - from_y + LOS_CACHE_RADIUS;
+    int col = to_x - from_x + LOS_CACHE_RADIUS;
+
+    if (row < 0 || row >= LOS_CACHE_SIZE || col < 0 || col >= LOS_CACHE_SIZE) {
+        return losTrace(from_y, from_x, to_y, to_x);
+    }
+
+    LosCache_t *cache = losCacheForSource(from_y, from_x);
+    if (cache == nullptr) {
+        return losTrace(from_y, from_x, to_y, to_x);
+    }
+
+    uint64_t bit = (uint64_t) 1 << col;
+
+    if ((cache->known[row] & bit) == 0) {
+        cache->known[row] |= bit;
+
+        if (losTrace(from_y, from_x, to_y, to_x)) {
+            cache->visible[row] |= bit;
+        } else {
+            cache->visible[row] &= ~bit;
+        }
+    }
+
+    return (cache->visible[row] & bit) != 0;
+}
+
 /*
   An enhanced look, with peripheral vision. Looking all 8 -CJS- directions will
   see everything which ought to be visible. Can specify direction 5, which looks
@@ -515,7 +608,7 @@ static bool lookSee(int x, int y, bool &transparent) {
         }
     }
 
-    if (tile.temporary_light || tile.permanent_light || tile.field_mark) {
+    if (caveTileVisible(Coord_t{y, x})) {
         const char *wall_description;
 
         if (tile.treasure_id != 0) {
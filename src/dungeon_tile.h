@@ -10,14 +10,12 @@
 
 // Tile_t holds data about a specific tile in the dungeon.
 typedef struct {
-    uint8_t creature_id; // ID for any creature occupying the tile
-    uint8_t treasure_id; // ID for any treasure item occupying the tile
-    uint8_t feature_id;  // ID of cave feature; walls, floors, open space, etc.
+    uint16_t creature_id; // ID for any creature occupying the tile
+    uint16_t treasure_id; // ID for any treasure item occupying the tile
+    uint8_t feature_id;   // ID of cave feature; walls, floors, open space, etc.
 
-    bool perma_lit_room  : 1; // Room should be lit with perm light, walls with this set should be perm lit after tunneled out.
-    bool field_mark      : 1; // Field mark, used for traps/doors/stairs, object is hidden if fm is false.
-    bool permanent_light : 1; // Permanent light, used for walls and lighted rooms.
-    bool temporary_light : 1; // Temporary light, used for player's lamp light,etc.
+    // The lighting and field mark flags are kept separately, as bit planes
+    // of the whole floor, see `Floor_t`.
 } Tile_t;
 
 // `fval` definitions: these describe the various types of dungeon floors and
@@ -11,9 +11,6 @@
 #include "headers.h"
 #include "version.h"
 
-// holds the previous rnd state
-static uint32_t old_seed;
-
 Game_t game = Game_t{};
 
 // gets a new random seed for the random number generator
@@ -40,47 +37,66 @@ void seedsInitialize(uint32_t seed) {
     }
 }
 
-// change to different random number generator state
-void seedSet(uint32_t seed) {
-    old_seed = getRandomSeed();
-
-    // want reproducible state here
-    setRandomSeed(seed);
-}
-
-// restore the normal random generator state
-void seedResetToOldSeed() {
-    setRandomSeed(old_seed);
-}
-
 // Generates a random integer x where 1<=X<=MAXVAL -RAK-
 int randomNumber(int const max) {
     return (rnd() % max) + 1;
 }
 
-// Generates a random integer number of NORMAL distribution -RAK-
-int randomNumberNormalDistribution(int mean, int standard) {
-    // alternate randomNumberNormalDistribution() code, slower but much smaller since no table
-    // 2 per 1,000,000 will be > 4*SD, max is 5*SD
-    //
-    // tmp = diceRoll(8, 99);             // mean 400, SD 81
-    // tmp = (tmp - 400) * standard / 81;
-    // return tmp + mean;
+// Fills `values` with `count` random integers where 1<=X<=MAXVAL, giving the
+// same numbers as calling randomNumber() `count` times.
+void randomNumbers(int *values, int count, int const max) {
+    static_assert(sizeof(int) == sizeof(int32_t), "randomNumbers() fills the int buffer with rnd() values");
 
-    int tmp = randomNumber(MAX_SHORT);
+    auto raw = reinterpret_cast<int32_t *>(values);
+    rndFill(raw, count);
 
-    // off scale, assign random value between 4 and 5 times SD
-    if (tmp == MAX_SHORT) {
-        int offset = 4 * standard + randomNumber(standard);
-
-        // one half are negative
-        if (randomNumber(2) == 1) {
-            offset = -offset;
-        }
-
-        return mean + offset;
+    for (int i = 0; i < count; i++) {
+        values[i] = (raw[i] % max) + 1;
     }
+}
+
+// this table is used to generate a pseudo-normal distribution.  See
+// the function randomNumberNormalDistribution() below, this is much faster than calling
+// transcendental function to calculate a true normal distribution.
+static constexpr uint16_t normal_table[NORMAL_TABLE_SIZE] = {
+    206,     613,    1022,    1430,    1838,    2245,    2652,    3058,
+    3463,    3867,    4271,    4673,    5075,    5475,    5874,    6271,
+    6667,    7061,    7454,    7845,    8234,    8621,    9006,    9389,
+    9770,   10148,   10524,   10898,   11269,   11638,   12004,   12367,
+    12727,   13085,   13440,   13792,   14140,   14486,   14828,   15168,
+    15504,   15836,   16166,   16492,   16814,   17133,   17449,   17761,
+    18069,   18374,   18675,   18972,   19266,   19556,   19842,   20124,
+    20403,   20678,   20949,   21216,   21479,   21738,   21994,   22245,
+    22493,   22737,   22977,   23213,   23446,   23674,   23899,   24120,
+    24336,   24550,   24759,   24965,   25166,   25365,   25559,   25750,
+    25937,   26120,   26300,   26476,   26649,   26818,   26983,   27146,
+    27304,   27460,   27612,   27760,   27906,   28048,   28187,   28323,
+    28455,   28585,   28711,   28835,   28955,   29073,   29188,   29299,
+    29409,   29515,   29619,   29720,   29818,   29914,   30007,   30098,
+    30186,   30272,   30356,   30437,   30516,   30593,   30668,   30740,
+    30810,   30879,   30945,   31010,   31072,   31133,   31192,   31249,
+    31304,   31358,   31410,   31460,   31509,   31556,   31601,   31646,
+    31688,   31730,   31770,   31808,   31846,   31882,   31917,   31950,
+    31983,   32014,   32044,   32074,   32102,   32129,   32155,   32180,
+    32205,   32228,   32251,   32273,   32294,   32314,   32333,   32352,
+    32370,   32387,   32404,   32420,   32435,   32450,   32464,   32477,
+    32490,   32503,   32515,   32526,   32537,   32548,   32558,   32568,
+    32577,   32586,   32595,   32603,   32611,   32618,   32625,   32632,
+    32639,   32645,   32651,   32657,   32662,   32667,   32672,   32677,
+    32682,   32686,   32690,   32694,   32698,   32702,   32705,   32708,
+    32711,   32714,   32717,   32720,   32722,   32725,   32727,   32729,
+    32731,   32733,   32735,   32737,   32739,   32740,   32742,   32743,
+    32745,   32746,   32747,   32748,   32749,   32750,   32751,   32752,
+    32753,   32754,   32755,   32756,   32757,   32757,   32758,   32758,
+    32759,   32760,   32760,   32761,   32761,   32761,   32762,   32762,
+    32763,   32763,   32763,   32764,   32764,   32764,   32764,   32765,
+    32765,   32765,   32765,   32766,   32766,   32766,   32766,   32766,
+};
 
+// The normal_table binary search, as done by randomNumberNormalDistribution()
+// before the lookup table below was added. The table has duplicate entries,
+// so the index found depends on the search path, and this must be kept.
+static constexpr int normalTableSearch(int tmp) {
     // binary search normal normal_table to get index that
     // matches tmp this takes up to 8 iterations.
     int low = 0;
@@ -106,6 +122,53 @@ int randomNumberNormalDistribution(int mean, int standard) {
         iindex = iindex + 1;
     }
 
+    return iindex;
+}
+
+// normal_table index for every randomNumber(MAX_SHORT) value, except
+// MAX_SHORT itself which is off the scale of the table.
+typedef struct {
+    uint8_t index[MAX_SHORT];
+} NormalTableIndex_t;
+
+static constexpr NormalTableIndex_t normalTableIndexCreate() {
+    NormalTableIndex_t table = {};
+
+    for (int tmp = 1; tmp < MAX_SHORT; tmp++) {
+        table.index[tmp] = (uint8_t) normalTableSearch(tmp);
+    }
+
+    return table;
+}
+
+// Worked out at compile time, so each sample is a single table read.
+static constexpr NormalTableIndex_t normal_table_index = normalTableIndexCreate();
+
+// Generates a random integer number of NORMAL distribution -RAK-
+int randomNumberNormalDistribution(int mean, int standard) {
+    // alternate randomNumberNormalDistribution() code, slower but much smaller since no table
+    // 2 per 1,000,000 will be > 4*SD, max is 5*SD
+    //
+    // tmp = diceRoll(8, 99);             // mean 400, SD 81
+    // tmp = (tmp - 400) * standard / 81;
+    // return tmp + mean;
+
+    int tmp = randomNumber(MAX_SHORT);
+
+    // off scale, assign random value between 4 and 5 times SD
+    if (tmp == MAX_SHORT) {
+        int offset = 4 * standard + randomNumber(standard);
+
+        // one half are negative
+        if (randomNumber(2) == 1) {
+            offset = -offset;
+        }
+
+        return mean + offset;
+    }
+
+    int iindex = normal_table_index.index[tmp];
+
     // normal_table is based on SD of 64, so adjust the
     // index value here, round the half way case up.
     int offset = ((standard * iindex) + (NORMAL_TABLE_SD >> 1)) / NORMAL_TABLE_SD;
@@ -327,7 +390,9 @@ bool getAllDirections(const char *prompt, int &direction) {
 
 // Restore the terminal and exit
 void exitProgram() {
+    autosaveStop();
     flushInputBuffer();
     terminalRestore();
+    replayStop();
     exit(0);
 }
@@ -41,9 +41,9 @@ constexpr uint16_t MAX_OBJECTS_IN_GAME = 420; // Number of objects for universe
 constexpr uint16_t MAX_DUNGEON_OBJECTS = 344; // Number of dungeon objects
 constexpr uint16_t OBJECT_IDENT_SIZE = 448;   // 7*64, see object_offset() in desc.cpp, could be MAX_OBJECTS o_o() rewritten
 
-// With LEVEL_MAX_OBJECTS set to 150, it's possible to get compacting
-// objects during level generation, although it is extremely rare.
-constexpr uint8_t LEVEL_MAX_OBJECTS = 175;        // Max objects per level
+// With LEVEL_MAX_OBJECTS set to 150, it was possible to get compacting
+// objects during level generation, although it was extremely rare.
+constexpr uint16_t LEVEL_MAX_OBJECTS = 1000;      // Max objects per level
 
 // definitions for the pseudo-normal distribution generation
 constexpr uint16_t NORMAL_TABLE_SIZE = 256;
@@ -54,13 +54,11 @@ extern int eof_flag;
 extern bool panic_save;
 extern int16_t sorted_objects[MAX_DUNGEON_OBJECTS];
 extern int16_t current_treasure_id;
-extern uint16_t normal_table[NORMAL_TABLE_SIZE];
 extern int16_t treasure_levels[TREASURE_MAX_LEVELS + 1];
 
 void seedsInitialize(uint32_t seed);
-void seedSet(uint32_t seed);
-void seedResetToOldSeed();
 int randomNumber(int max);
+void randomNumbers(int *values, int count, int max);
 int randomNumberNormalDistribution(int mean, int standard);
 void setGameOptions();
 bool validGameVersion(uint8_t major, uint8_t minor, uint8_t patch);
@@ -74,7 +72,9 @@ void exitProgram();
 
 // game object management
 int popt();
-void pusht(uint8_t treasure_id);
+void pusht(int treasure_id);
+void dungeonPlaceTreasure(Coord_t const &coord, int treasure_id);
+void treasureLocationsRebuild();
 int itemGetRandomObjectId(int level, bool must_be_small);
 
 // game files
@@ -91,8 +91,27 @@ void endGame();
 // save/load
 bool saveGame();
 bool loadGame(bool &generate);
+void autosaveSetInterval(int32_t turns);
+void autosaveCheck(bool new_level);
+void autosaveStop();
+bool listSaveFiles(const std::string &directory);
 void setFileptr(FILE *file);
 
+// replays
+bool replayStartRecording(const std::string &filename);
+bool replayStartPlayback(const std::string &filename, uint32_t &seed, bool &new_game, bool &roguelike_keys);
+bool replayIsPlaying();
+bool replayIsRecording();
+void replayRecordStart(uint32_t seed, bool new_game, bool roguelike_keys);
+void replayRecordKey(char key);
+void replayRecordKeyPress(bool key_pressed);
+int replayNextKey();
+bool replayNextKeyPress();
+void replayTurnCompleted();
+void replayStop();
+
 // game_run.cpp
 // (includes the playDungeon() main game loop)
 void startMoria(int seed, bool start_new_game, bool use_roguelike_keys);
+void initializeMonsterLevels();
+void initializeTreasureLevels();
@@ -142,8 +142,8 @@ void endGame() {
         (void) saveGame();
     }
 
-    // add score to score file if applicable
-    if (game.character_generated) {
+    // add score to score file if applicable, which a replay never is
+    if (game.character_generated && !replayIsPlaying()) {
         // Clear `game.character_saved`, strange thing to do, but it prevents
         // getKeyInput() from recursively calling endGame() when there has
         // been an eof on stdin detected.
@@ -181,7 +181,7 @@ void outputRandomLevelObjectsToFile() {
         (void) fprintf(file_ptr, "%d %s\n", item.depth_first_found, input);
     }
 
-    pusht((uint8_t) treasure_id);
+    pusht(treasure_id);
 
     (void) fclose(file_ptr);
 
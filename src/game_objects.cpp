@@ -13,46 +13,100 @@
 int16_t sorted_objects[MAX_DUNGEON_OBJECTS];
 int16_t treasure_levels[TREASURE_MAX_LEVELS + 1];
 
+// Where each object in treasure_list is on the dungeon floor, so that moving
+// an object to another slot doesn't need a search of the whole dungeon.
+// Objects not on the floor, e.g. those being made for the stores, are never
+// placed, which is spotted as the tile not holding the object.
+static Coord_t treasure_coords[LEVEL_MAX_OBJECTS];
+
+static bool treasureIsOnFloor(int treasure_id) {
+    Coord_t const &coord = treasure_coords[treasure_id];
+
+    return coord.y >= 0 && coord.y < dg.height && coord.x >= 0 && coord.x < dg.width && dg.floor[coord.y][coord.x].treasure_id == treasure_id;
+}
+
+// Puts an object from popt() on the dungeon floor
+void dungeonPlaceTreasure(Coord_t const &coord, int treasure_id) {
+    dg.floor[coord.y][coord.x].treasure_id = (uint16_t) treasure_id;
+    treasure_coords[treasure_id] = coord;
+}
+
+// Find the objects after the dungeon floor has been loaded
+void treasureLocationsRebuild() {
+    for (auto &coord : treasure_coords) {
+        coord = Coord_t{-1, -1};
+    }
+
+    for (int y = 0; y < dg.height; y++) {
+        for (int x = 0; x < dg.width; x++) {
+            int treasure_id = dg.floor[y][x].treasure_id;
+            if (treasure_id != 0 && treasure_id < LEVEL_MAX_OBJECTS) {
+                treasure_coords[treasure_id] = Coord_t{y, x};
+            }
+        }
+    }
+}
+
 // If too many objects on floor level, delete some of them-RAK-
 static void compactObjects() {
     printMessage("Compacting objects...");
 
+    // The objects are looked at in the order they appear on the map, top
+    // to bottom, left to right, as the random numbers used depend on it.
+    Coord_t coords[LEVEL_MAX_OBJECTS];
+    int coords_count = 0;
+
+    for (int id = config::treasure::MIN_TREASURE_LIST_ID; id < current_treasure_id; id++) {
+        if (!treasureIsOnFloor(id)) {
+            continue;
+        }
+
+        Coord_t const &coord = treasure_coords[id];
+
+        int i = coords_count++;
+        for (; i > 0 && (coords[i - 1].y > coord.y || (coords[i - 1].y == coord.y && coords[i - 1].x > coord.x)); i--) {
+            coords[i] = coords[i - 1];
+        }
+        coords[i] = coord;
+    }
+
     int counter = 0;
     int current_distance = 66;
 
     while (counter <= 0) {
-        for (int y = 0; y < dg.height; y++) {
-            for (int x = 0; x < dg.width; x++) {
-                if (dg.floor[y][x].treasure_id != 0 && coordDistanceBetween(Coord_t{y, x}, Coord_t{py.row, py.col}) > current_distance) {
-                    int chance;
-
-                    switch (treasure_list[dg.floor[y][x].treasure_id].category_id) {
-                        case TV_VIS_TRAP:
-                            chance = 15;
-                            break;
-                        case TV_INVIS_TRAP:
-                        case TV_RUBBLE:
-                        case TV_OPEN_DOOR:
-                        case TV_CLOSED_DOOR:
-                            chance = 5;
-                            break;
-                        case TV_UP_STAIR:
-                        case TV_DOWN_STAIR:
-                        case TV_STORE_DOOR:
-                            // Stairs, don't delete them.
-                            // Shop doors, don't delete them.
-                            chance = 0;
-                            break;
-                        case TV_SECRET_DOOR: // secret doors
-                            chance = 3;
-                            break;
-                        default:
-                            chance = 10;
-                    }
-                    if (randomNumber(100) <= chance) {
-                        (void) dungeonDeleteObject(Coord_t{y, x});;
-                        counter++;
-                    }
+        for (int i = 0; i < coords_count; i++) {
+            int y = coords[i].y;
+            int x = coords[i].x;
+
+            if (dg.floor[y][x].treasure_id != 0 && coordDistanceBetween(Coord_t{y, x}, Coord_t{py.row, py.col}) > current_distance) {
+                int chance;
+
+                switch (treasure_list[dg.floor[y][x].treasure_id].category_id) {
+                    case TV_VIS_TRAP:
+                        chance = 15;
+                        break;
+                    case TV_INVIS_TRAP:
+                    case TV_RUBBLE:
+                    case TV_OPEN_DOOR:
+                    case TV_CLOSED_DOOR:
+                        chance = 5;
+                        break;
+                    case TV_UP_STAIR:
+                    case TV_DOWN_STAIR:
+                    case TV_STORE_DOOR:
+                        // Stairs, don't delete them.
+                        // Shop doors, don't delete them.
+                        chance = 0;
+                        break;
+                    case TV_SECRET_DOOR: // secret doors
+                        chance = 3;
+                        break;
+                    default:
+                        chance = 10;
+                }
+                if (randomNumber(100) <= chance) {
+                    (void) dungeonDeleteObject(Coord_t{y, x});;
+                    counter++;
                 }
             }
         }
@@ -79,17 +133,15 @@ int popt() {
 // Pushes a record back onto free space list -RAK-
 // `dungeonDeleteObject()` should always be called instead, unless the object
 // in question is not in the dungeon, e.g. in store1.c and files.c
-void pusht(uint8_t treasure_id) {
-    if (treasure_id != current_treasure_id - 1) {
-        treasure_list[treasure_id] = treasure_list[current_treasure_id - 1];
+void pusht(int treasure_id) {
+    int last_id = current_treasure_id - 1;
+
+    if (treasure_id != last_id) {
+        treasure_list[treasure_id] = treasure_list[last_id];
 
         // must change the treasure_id in the cave of the object just moved
-        for (int y = 0; y < dg.height; y++) {
-            for (int x = 0; x < dg.width; x++) {
-                if (dg.floor[y][x].treasure_id == current_treasure_id - 1) {
-                    dg.floor[y][x].treasure_id = treasure_id;
-                }
-            }
+        if (treasureIsOnFloor(last_id)) {
+            dungeonPlaceTreasure(treasure_coords[last_id], treasure_id);
         }
     }
     current_treasure_id--;
@@ -0,0 +1,288 @@
+// Copyright (c) 1981-86 Robert A. Koeneke
+// Copyright (c) 1987-94 James E. Wilson
+//
+// This work is free software released under the GNU General Public License
+// version 2.0, and comes with ABSOLUTELY NO WARRANTY.
+//
+// See LICENSE and AUTHORS for more information.
+
+// Keystroke recording and playback of games
+
+#include "headers.h"
+
+#include <chrono>
+#include <vector>
+
+// A replay file starts with a small header holding the game seed and the
+// start up options, followed by the keystrokes in the order they were read.
+//
+// Each key returned by getKeyInput() is stored as a single byte. The escape
+// byte REPLAY_ESCAPE introduces the less common records:
+//
+//   ESCAPE ESCAPE         the key 0xFF itself
+//   ESCAPE KEY_PRESS n    a checkForNonBlockingKeyPress() which found a key,
+//                         after `n` (varint) polls which found nothing
+//
+// Polls which find nothing are only counted, so resting and running cost
+// nothing in the file, yet a disturbance is replayed on the very same turn.
+//
+// Only new games are recorded, as a restored game would play out from
+// whatever the save file holds when it is played back.
+
+static const char REPLAY_MAGIC[] = {'U', 'M', 'R', 'P'};
+// Version 2 only checks the keyboard every few turns when fast forwarding,
+// so the polls of a version 1 recording no longer line up. Version 3 stocks
+// the stores from their own random stream, which changes the rest of the game.
+// So does version 4, which no longer nudges the game's stream when laying
+// out the town and naming the magic items.
+constexpr uint8_t REPLAY_VERSION = 4;
+
+constexpr uint8_t REPLAY_ESCAPE = 0xFF;
+constexpr uint8_t REPLAY_KEY_PRESS = 0x01;
+
+constexpr uint8_t REPLAY_NEW_GAME = 0x01;
+constexpr uint8_t REPLAY_ROGUELIKE_KEYS = 0x02;
+
+// The dungeon scale, less one, is kept in the two bits above the options
+constexpr uint8_t REPLAY_SCALE_SHIFT = 2;
+constexpr uint8_t REPLAY_SCALE_MASK = 0x03;
+
+static FILE *record_file = nullptr;
+
+// The whole recording is read into memory for playback,
+// so there are no input waits when replaying at full speed.
+static bool playing_back = false;
+static std::vector<uint8_t> playback_data;
+static size_t playback_pos = 0;
+
+// Non-blocking key polls since the last record was read or written
+static uint32_t polls_since_last_record = 0;
+
+// Playback statistics, used to benchmark the game
+static uint32_t playback_turns = 0;
+static std::chrono::steady_clock::time_point playback_start_time;
+
+static void writeVarint(uint32_t value) {
+    while (value >= 0x80) {
+        (void) putc((int) ((value & 0x7F) | 0x80), record_file);
+        value >>= 7;
+    }
+    (void) putc((int) value, record_file);
+}
+
+static int readByte() {
+    if (playback_pos >= playback_data.size()) {
+        return EOF;
+    }
+    return playback_data[playback_pos++];
+}
+
+static uint32_t readVarint() {
+    uint32_t value = 0;
+
+    for (int shift = 0; shift < 32; shift += 7) {
+        int byte = readByte();
+        if (byte == EOF) {
+            break;
+        }
+
+        value |= (uint32_t) (byte & 0x7F) << shift;
+
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+
+    return value;
+}
+
+static void writeLong(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        (void) putc((int) ((value >> (i * 8)) & 0xFF), record_file);
+    }
+}
+
+static uint32_t readLong() {
+    uint32_t value = 0;
+
+    for (int i = 0; i < 4; i++) {
+        value |= (uint32_t) (readByte() & 0xFF) << (i * 8);
+    }
+
+    return value;
+}
+
+bool replayStartRecording(const std::string &filename) {
+    record_file = fopen(filename.c_str(), "wb");
+
+    return record_file != nullptr;
+}
+
+// Opens a replay file for playback, returning the options the game was started with.
+bool replayStartPlayback(const std::string &filename, uint32_t &seed, bool &new_game, bool &roguelike_keys) {
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    uint8_t buffer[4096];
+    size_t count;
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        playback_data.insert(playback_data.end(), buffer, buffer + count);
+    }
+    (void) fclose(file);
+
+    size_t header_size = sizeof(REPLAY_MAGIC) + 6;
+    if (playback_data.size() < header_size || memcmp(playback_data.data(), REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0) {
+        return false;
+    }
+
+    playback_pos = sizeof(REPLAY_MAGIC);
+    if (readByte() != REPLAY_VERSION) {
+        return false;
+    }
+
+    seed = readLong();
+
+    auto flags = (uint8_t) readByte();
+    new_game = (flags & REPLAY_NEW_GAME) != 0;
+    roguelike_keys = (flags & REPLAY_ROGUELIKE_KEYS) != 0;
+    dungeonSetScale(((flags >> REPLAY_SCALE_SHIFT) & REPLAY_SCALE_MASK) + 1);
+
+    playing_back = true;
+    playback_start_time = std::chrono::steady_clock::now();
+
+    return true;
+}
+
+bool replayIsPlaying() {
+    return playing_back;
+}
+
+bool replayIsRecording() {
+    return record_file != nullptr;
+}
+
+// Writes the replay header, called once the game seed is known.
+void replayRecordStart(uint32_t seed, bool new_game, bool roguelike_keys) {
+    if (record_file == nullptr) {
+        return;
+    }
+
+    uint8_t flags = 0;
+    if (new_game) {
+        flags |= REPLAY_NEW_GAME;
+    }
+    if (roguelike_keys) {
+        flags |= REPLAY_ROGUELIKE_KEYS;
+    }
+    flags |= ((dg.scale - 1) & REPLAY_SCALE_MASK) << REPLAY_SCALE_SHIFT;
+
+    (void) fwrite(REPLAY_MAGIC, sizeof(REPLAY_MAGIC), 1, record_file);
+    (void) putc(REPLAY_VERSION, record_file);
+    writeLong(seed);
+    (void) putc(flags, record_file);
+    (void) fflush(record_file);
+}
+
+// Every record is flushed straight away, so the file
+// is complete even when the game crashes.
+void replayRecordKey(char key) {
+    if (record_file == nullptr) {
+        return;
+    }
+
+    auto byte = (uint8_t) key;
+    if (byte == REPLAY_ESCAPE) {
+        (void) putc(REPLAY_ESCAPE, record_file);
+    }
+    (void) putc(byte, record_file);
+    (void) fflush(record_file);
+
+    polls_since_last_record = 0;
+}
+
+void replayRecordKeyPress(bool key_pressed) {
+    if (record_file == nullptr) {
+        return;
+    }
+
+    if (!key_pressed) {
+        polls_since_last_record++;
+        return;
+    }
+
+    (void) putc(REPLAY_ESCAPE, record_file);
+    (void) putc(REPLAY_KEY_PRESS, record_file);
+    writeVarint(polls_since_last_record);
+    (void) fflush(record_file);
+
+    polls_since_last_record = 0;
+}
+
+// Next key from the replay, or EOF when the recording has ended.
+int replayNextKey() {
+    while (true) {
+        int byte = readByte();
+        if (byte != REPLAY_ESCAPE) {
+            polls_since_last_record = 0;
+            return byte;
+        }
+
+        byte = readByte();
+        if (byte != REPLAY_KEY_PRESS) {
+            polls_since_last_record = 0;
+            return byte;
+        }
+
+        // The recording expected a key press before this key, which means
+        // the replay is out of step with the game. Skip it and carry on.
+        (void) readVarint();
+    }
+}
+
+// Replays a checkForNonBlockingKeyPress(), which is only true on the same poll as when recorded.
+bool replayNextKeyPress() {
+    size_t record_start = playback_pos;
+
+    bool key_pressed = readByte() == REPLAY_ESCAPE && readByte() == REPLAY_KEY_PRESS && readVarint() == polls_since_last_record;
+
+    if (!key_pressed) {
+        playback_pos = record_start;
+        polls_since_last_record++;
+        return false;
+    }
+
+    polls_since_last_record = 0;
+
+    return true;
+}
+
+// Called for each game turn, so the turn rate can be reported.
+void replayTurnCompleted() {
+    playback_turns++;
+}
+
+// Close any replay files, reporting the turn rate of a playback.
+void replayStop() {
+    if (record_file != nullptr) {
+        (void) fclose(record_file);
+        record_file = nullptr;
+    }
+
+    if (!playing_back) {
+        return;
+    }
+
+    playing_back = false;
+    playback_data.clear();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - playback_start_time;
+    double seconds = elapsed.count();
+
+    std::cerr << "Replay: " << playback_turns << " turns in " << seconds << " seconds";
+    if (seconds > 0) {
+        std::cerr << " (" << (uint32_t) (playback_turns / seconds) << " turns/sec)";
+    }
+    std::cerr << "\n";
+}
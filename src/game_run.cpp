@@ -13,8 +13,6 @@
 static void playDungeon();
 
 static void initializeCharacterInventory();
-static void initializeMonsterLevels();
-static void initializeTreasureLevels();
 static void priceAdjust();
 static char originalCommands(char command);
 static void doCommand(char command);
@@ -28,13 +26,24 @@ static void dungeonGoDownLevel();
 static void dungeonJamDoor();
 static void inventoryRefillLamp();
 
+// While resting, repeating a command or running, the keyboard is only
+// checked every few turns, and without waiting on it, so a long rest is
+// not held up by the terminal.
+constexpr int FAST_FORWARD_POLL_TURNS = 16;
+
 void startMoria(int seed, bool start_new_game, bool use_roguelike_keys) {
+    // Take the seed from the clock now, rather than in seedsInitialize(),
+    // so that it can be written to the replay before any keys are read.
+    if (seed == 0) {
+        seed = (int) getCurrentUnixTime();
+    }
+    replayRecordStart((uint32_t) seed, start_new_game, use_roguelike_keys);
+
     priceAdjust();
 
     // Show the game splash screen
     displaySplashScreen();
 
-    // Grab a random seed from the clock
     seedsInitialize(static_cast<uint32_t>(seed));
 
     // Init monster and treasure levels for allocate
@@ -130,6 +139,7 @@ void startMoria(int seed, bool start_new_game, bool use_roguelike_keys) {
 
     if (generate) {
         generateCave();
+        autosaveCheck(true);
     }
 
     // Loop till dead, or exit
@@ -152,6 +162,7 @@ void startMoria(int seed, bool start_new_game, bool use_roguelike_keys) {
         // New level if not dead
         if (!game.character_is_dead) {
             generateCave();
+            autosaveCheck(true);
         }
     }
 
@@ -189,7 +200,7 @@ static void initializeCharacterInventory() {
 }
 
 // Initializes M_LEVEL array for use with PLACE_MONSTER -RAK-
-static void initializeMonsterLevels() {
+void initializeMonsterLevels() {
     for (auto &level : monster_levels) {
         level = 0;
     }
@@ -204,7 +215,7 @@ static void initializeMonsterLevels() {
 }
 
 // Initializes T_LEVEL array for use with PLACE_OBJECT -RAK-
-static void initializeTreasureLevels() {
+void initializeTreasureLevels() {
     for (auto &level : treasure_levels) {
         level = 0;
     }
@@ -681,6 +692,23 @@ static void playerUpdateRestingState() {
     }
 }
 
+// Resting, repeating a command or running, none of which wait for a key.
+static bool playerIsFastForwarding() {
+    return game.command_count > 0 || py.running_tracker != 0 || py.flags.rest != 0;
+}
+
+// On most turns none of the timed effects are running, so their counters are
+// checked all at once, before going through the effects one at a time.
+// Negative counters do nothing either, but are left for each effect to skip.
+static bool playerAilmentsActive() {
+    return (py.flags.blind | py.flags.confused | py.flags.afraid | py.flags.poisoned | py.flags.fast | py.flags.slow) != 0;
+}
+
+static bool playerTimedEffectsActive() {
+    return (py.flags.image | py.flags.paralysis | py.flags.protect_evil | py.flags.invulnerability | py.flags.blessed | py.flags.heat_resistance |
+            py.flags.cold_resistance | py.flags.detect_invisible | py.flags.timed_infra | py.flags.word_of_recall) != 0;
+}
+
 // Hallucinating?   (Random characters appear!)
 static void playerUpdateHallucination() {
     if (py.flags.image <= 0) {
@@ -2219,7 +2247,7 @@ static void examineBook() {
 
 // Go up one level -RAK-
 static void dungeonGoUpLevel() {
-    uint8_t tile_id = dg.floor[py.row][py.col].treasure_id;
+    uint16_t tile_id = dg.floor[py.row][py.col].treasure_id;
 
     if (tile_id != 0 && treasure_list[tile_id].category_id == TV_UP_STAIR) {
         dg.current_level--;
@@ -2236,7 +2264,7 @@ static void dungeonGoUpLevel() {
 
 // Go down one level -RAK-
 static void dungeonGoDownLevel() {
-    uint8_t tile_id = dg.floor[py.row][py.col].treasure_id;
+    uint16_t tile_id = dg.floor[py.row][py.col].treasure_id;
 
     if (tile_id != 0 && treasure_list[tile_id].category_id == TV_DOWN_STAIR) {
         dg.current_level++;
@@ -2389,15 +2417,20 @@ static void playDungeon() {
     // over different iterations of the main loop below -MRC-
     char lastInputCommand = {0};
 
+    // Whether fast forwarding, and the turns since the keyboard was checked
+    bool fast_forwarding = false;
+    int fast_forward_turns = 0;
+
     // Loop until dead,  or new level
     // Exit when `dg.generate_new_level` and `eof_flag` are both set
     do {
         // Increment turn counter
         dg.game_turn++;
+        replayTurnCompleted();
 
         // turn over the store contents every, say, 1000 turns
         if (dg.current_level != 0 && dg.game_turn % 1000 == 0) {
-            storeMaintenance();
+            storeMaintenanceDue();
         }
 
         // Check for creature generation
@@ -2417,29 +2450,42 @@ static void playDungeon() {
         int regen_amount = playerFoodConsumption();
         playerUpdateRegeneration(regen_amount);
 
-        playerUpdateBlindness();
-        playerUpdateConfusion();
-        playerUpdateFearState();
-        playerUpdatePoisonedState();
-        playerUpdateSpeed();
+        if (playerAilmentsActive()) {
+            playerUpdateBlindness();
+            playerUpdateConfusion();
+            playerUpdateFearState();
+            playerUpdatePoisonedState();
+            playerUpdateSpeed();
+        }
         playerUpdateRestingState();
 
         // Check for interrupts to find or rest.
-        int microseconds = (py.running_tracker != 0 ? 0 : 10000);
-        if ((game.command_count > 0 || (py.running_tracker != 0) || py.flags.rest != 0) && checkForNonBlockingKeyPress(microseconds)) {
-            playerDisturb(0, 0);
+        if (playerIsFastForwarding()) {
+            fast_forwarding = true;
+            terminalFastForwardStart();
+
+            fast_forward_turns++;
+            if (fast_forward_turns >= FAST_FORWARD_POLL_TURNS) {
+                fast_forward_turns = 0;
+
+                if (checkForNonBlockingKeyPress(0)) {
+                    playerDisturb(0, 0);
+                }
+            }
         }
 
-        playerUpdateHallucination();
-        playerUpdateParalysis();
-        playerUpdateEvilProtection();
-        playerUpdateInvulnerability();
-        playerUpdateBlessedness();
-        playerUpdateHeatResistance();
-        playerUpdateColdResistance();
-        playerUpdateDetectInvisible();
-        playerUpdateInfraVision();
-        playerUpdateWordOfRecall();
+        if (playerTimedEffectsActive()) {
+            playerUpdateHallucination();
+            playerUpdateParalysis();
+            playerUpdateEvilProtection();
+            playerUpdateInvulnerability();
+            playerUpdateBlessedness();
+            playerUpdateHeatResistance();
+            playerUpdateColdResistance();
+            playerUpdateDetectInvisible();
+            playerUpdateInfraVision();
+            playerUpdateWordOfRecall();
+        }
 
         // Random teleportation
         if (py.flags.teleport && randomNumber(100) == 1) {
@@ -2494,5 +2540,19 @@ static void playDungeon() {
         if (!dg.generate_new_level) {
             updateMonsters(true);
         }
+
+        // Show everything that happened while fast forwarding, now it is over.
+        if (fast_forwarding && !playerIsFastForwarding()) {
+            fast_forwarding = false;
+            fast_forward_turns = 0;
+            panelMoveCursor(Coord_t{py.row, py.col});
+            terminalFastForwardEnd();
+        }
+
+        if (!dg.generate_new_level) {
+            autosaveCheck(false);
+        }
     } while (!dg.generate_new_level && (eof_flag == 0));
+
+    terminalFastForwardEnd();
 }
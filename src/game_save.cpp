@@ -11,7 +11,12 @@
 #include "headers.h"
 #include "version.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 // For debugging the save file code on systems with broken compilers.
 #define DEBUG(x)
@@ -19,7 +24,31 @@
 DEBUG(static FILE *logfile)
 
 static bool _save_char(const std::string &filename);
-static bool sv_write();
+static void saveToBuffer();
+static void sv_write();
+static void autosaveWorker();
+static bool autosaveAppendChanges(const std::string &filename, std::vector<uint8_t> const &bytes);
+static bool autosaveWriteFile(const std::string &filename, std::vector<uint8_t> const &bytes);
+static FILE *writeStream(int fd);
+static bool writeAndSync(FILE *file, uint8_t const *bytes, size_t size, uint8_t const *summary);
+static void syncParentDirectory(const std::string &filename);
+static size_t savedChunkEnd(std::vector<uint8_t> const &bytes, size_t offset);
+static bool readDirectory(const std::string &directory, std::vector<std::string> &filenames);
+static void xorChainEncode(uint8_t *bytes, size_t size);
+static void xorChainDecode(uint8_t *bytes, size_t size);
+static uint32_t saveChecksum(uint8_t const *bytes, size_t size);
+static uint32_t getLong(uint8_t const *bytes);
+static uint16_t getShort(uint8_t const *bytes);
+static void setLong(uint8_t *bytes, uint32_t value);
+static void setShort(uint8_t *bytes, uint16_t value);
+static bool loadSaveFileBytes();
+static bool readSaveFile(uint8_t &version_maj, uint8_t &version_min, uint8_t &patch_level);
+static void closeSaveFile();
+static void wr_chunk_start(uint32_t id);
+static void wr_chunk_end();
+static bool rd_chunk(uint32_t id);
+static uint8_t const *rd_view(size_t size);
+static uint8_t *wr_reserve(size_t size);
 static void wr_bool(bool value);
 static void wr_byte(uint8_t value);
 static void wr_short(uint16_t value);
@@ -38,28 +67,154 @@ static void rd_bytes(uint8_t *value, int count);
 static void rd_string(char *str);
 static void rd_shorts(uint16_t *value, int count);
 static void rd_item(Inventory_t &item);
-static void rd_monster(Monster_t &monster);
+static void rd_monster(Monster_t &monster, bool wide_coordinates);
 
 // these are used for the save file, to avoid having to pass them to every procedure
 static FILE *fileptr;
-static uint8_t xor_byte;
 static int from_savefile;   // can overwrite old save file when save
 static uint32_t start_time; // time that play started
 
+// The save file is put together in memory, encrypted in one pass, and written
+// out in one go. Loading maps the whole file into memory where it can, or
+// reads it all into the buffer.
+static std::vector<uint8_t> save_buffer;
+static uint8_t save_key;      // encryption key of each chunk being written
+static size_t chunk_start;    // where the header of the chunk being written is
+
+// A save file is a short prefix and a summary of the character, followed
+// by chunks. Each chunk has a header, then its encrypted data, padded to the
+// next 8 bytes so the data of every chunk is aligned in memory once the file
+// is mapped.
+//
+//   prefix:  "UMSV", SAVE_FILE_FORMAT, game version major, minor, patch
+//   summary: see wr_summary(), not encrypted
+//   chunk:   id, size of data, checksum of data, 3 unused bytes, key, data
+//
+// Every save ends with a SYNC chunk. Autosaves may append just the chunks
+// which changed, and another SYNC, to the end of the file; a later chunk
+// takes the place of an earlier one with the same id, and anything after
+// the last SYNC is from an append which never finished, so is left out.
+//
+// Older save files are one encrypted stream, which starts with the game
+// version, so can never start with the SAVE_FILE_MAGIC. Format 2 files
+// have no SYNC, and the level floor tiles in the FLOR chunk. Format 2 and
+// 3 files have no summary.
+static const char SAVE_FILE_MAGIC[4] = {'U', 'M', 'S', 'V'};
+constexpr uint8_t SAVE_FILE_FORMAT = 4;
+constexpr size_t SAVE_FILE_PREFIX_SIZE = 8;
+constexpr size_t SAVE_SUMMARY_SIZE = 72;
+constexpr size_t SAVE_FILE_CHUNKS_OFFSET = SAVE_FILE_PREFIX_SIZE + SAVE_SUMMARY_SIZE;
+constexpr size_t SAVE_CHUNK_HEADER_SIZE = 16;
+constexpr size_t SAVE_CHUNK_ALIGNMENT = 8;
+
+constexpr uint32_t saveChunkId(char a, char b, char c, char d) {
+    return (uint32_t) (uint8_t) a | (uint32_t) (uint8_t) b << 8 | (uint32_t) (uint8_t) c << 16 | (uint32_t) (uint8_t) d << 24;
+}
+
+constexpr uint32_t SAVE_CHUNK_HEADER = saveChunkId('H', 'E', 'A', 'D');    // save time, died from, score, birth date
+constexpr uint32_t SAVE_CHUNK_RECALL = saveChunkId('R', 'C', 'A', 'L');    // monster memories
+constexpr uint32_t SAVE_CHUNK_PLAYER = saveChunkId('P', 'L', 'Y', 'R');    // options, character and flags
+constexpr uint32_t SAVE_CHUNK_INVENTORY = saveChunkId('I', 'N', 'V', 'T'); // inventory and equipment
+constexpr uint32_t SAVE_CHUNK_GAME = saveChunkId('G', 'A', 'M', 'E');      // spells, identified objects, seeds, messages
+constexpr uint32_t SAVE_CHUNK_STORES = saveChunkId('S', 'T', 'O', 'R');    // stores and their maintenance stream
+constexpr uint32_t SAVE_CHUNK_LEVEL = saveChunkId('F', 'L', 'O', 'R');     // level, and where its monsters and objects are, not saved for dead characters
+constexpr uint32_t SAVE_CHUNK_OBJECTS = saveChunkId('O', 'B', 'J', 'S');   // objects on the level
+constexpr uint32_t SAVE_CHUNK_MONSTERS = saveChunkId('M', 'O', 'N', 'S');  // monsters on the level
+constexpr uint32_t SAVE_CHUNK_SYNC = saveChunkId('S', 'Y', 'N', 'C');      // end of a save, no data
+
+// The floor tiles are saved in bands of rows, "FB00", "FB01", etc., so that
+// an autosave only has to write the bands which have changed.
+constexpr int SAVE_FLOOR_BAND_ROWS = 16;
+
+static uint32_t floorBandChunkId(int band) {
+    return saveChunkId('F', 'B', (char) ('0' + band / 10), (char) ('0' + band % 10));
+}
+
+// What is in the save file summary.
+typedef struct {
+    uint32_t time_saved;
+    int32_t points;
+    uint16_t level;
+    uint16_t dungeon_depth;
+    uint16_t deepest_dungeon_depth;
+    uint8_t race;
+    uint8_t character_class;
+    bool dead;
+    bool total_winner;
+    char name[PLAYER_NAME_SIZE];
+    char died_from[25];
+} SaveSummary_t;
+
+static void wr_summary(uint8_t *bytes);
+static void rd_summary(uint8_t const *bytes, SaveSummary_t &summary);
+static std::string printableText(const std::string &text);
+
+typedef struct {
+    uint32_t id;
+    uint32_t size;
+    uint32_t checksum;
+    size_t offset; // of the chunk data in the file
+    bool decrypted;
+} SaveChunk_t;
+
+static bool decryptChunk(SaveChunk_t &chunk);
+
+// The save file being loaded
+static uint8_t *file_bytes;
+static size_t file_size;
+static bool file_mapped;
+static bool chunked_file; // false for older save files
+static uint8_t file_format;
+static std::vector<SaveChunk_t> file_chunks;
+
+// What the rd_* functions are reading: a chunk, or the whole of an older
+// save file, or a score record.
+static uint8_t const *read_bytes;
+static size_t read_size;
+static size_t read_pos;
+static bool read_error; // read past the end, or a chunk is missing or damaged
+
 // This save package was brought to by                -JWT-
 // and                                                -RAK-
 // and has been completely rewritten for UNIX by      -JEW-
 // and has been completely rewritten again by         -CJS-
 // and completely rewritten again! for portability by -JEW-
 
-static bool sv_write() {
+static void sv_write() {
     // clear the game.character_is_dead flag when creating a HANGUP save file,
     // so that player can see tombstone when restart
     if (eof_flag != 0) {
         game.character_is_dead = false;
     }
 
-    uint32_t l = 0;
+    // The stores are saved as they would be had their maintenance not been put off.
+    storeMaintenanceCatchUp();
+
+    wr_chunk_start(SAVE_CHUNK_HEADER);
+
+    // save the current time in the save file
+    uint32_t l = getCurrentUnixTime();
+
+    if (l < start_time) {
+        // someone is messing with the clock!,
+        // assume that we have been playing for 1 day
+        l = (uint32_t) (start_time + 86400L);
+    }
+    wr_long(l);
+
+    // put game.character_died_from string in save file
+    wr_string(game.character_died_from);
+
+    // put the max_score in the save file
+    l = (uint32_t) (playerCalculateTotalPoints());
+    wr_long(l);
+
+    // put the date_of_birth in the save file
+    wr_long((uint32_t) py.misc.date_of_birth);
+
+    wr_chunk_end();
+
+    l = 0;
 
     if (config::options::run_cut_corners) {
         l |= 0x1;
@@ -102,6 +257,21 @@ static bool sv_write() {
         l |= 0x40000000L;
     }
 
+    // Tile creature and treasure ids are written as shorts,
+    // older save files have them as bytes.
+    l |= 0x20000000L;
+
+    // The dungeon scale is saved, and the dungeon coordinates are written
+    // as shorts. Older save files have byte coordinates, and only the
+    // normal sized dungeon.
+    l |= 0x10000000L;
+
+    // The store maintenance stream is saved after the stores,
+    // older save files start it again from the town seed.
+    l |= 0x08000000L;
+
+    wr_chunk_start(SAVE_CHUNK_RECALL);
+
     for (int i = 0; i < MON_MAX_CREATURES; i++) {
         Recall_t &r = creature_recall[i];
         if (r.movement || r.defenses || r.kills || r.spells || r.deaths || r.attacks[0] || r.attacks[1] || r.attacks[2] || r.attacks[3]) {
@@ -120,6 +290,10 @@ static bool sv_write() {
     // sentinel to indicate no more monster info
     wr_short((uint16_t) 0xFFFF);
 
+    wr_chunk_end();
+
+    wr_chunk_start(SAVE_CHUNK_PLAYER);
+
     wr_long(l);
 
     wr_string(py.misc.name);
@@ -215,6 +389,11 @@ static bool sv_write() {
 
     wr_short((uint16_t) missiles_counter);
     wr_long((uint32_t) dg.game_turn);
+
+    wr_chunk_end();
+
+    wr_chunk_start(SAVE_CHUNK_INVENTORY);
+
     wr_short((uint16_t) py.unique_inventory_items);
     for (int i = 0; i < py.unique_inventory_items; i++) {
         wr_item(inventory[i]);
@@ -224,6 +403,11 @@ static bool sv_write() {
     }
     wr_short((uint16_t) py.inventory_weight);
     wr_short((uint16_t) py.equipment_count);
+
+    wr_chunk_end();
+
+    wr_chunk_start(SAVE_CHUNK_GAME);
+
     wr_long(py.flags.spells_learnt);
     wr_long(py.flags.spells_worked);
     wr_long(py.flags.spells_forgotten);
@@ -242,6 +426,10 @@ static bool sv_write() {
     wr_short((uint16_t) game.noscore);
     wr_shorts(py.base_hp_levels, PLAYER_MAX_LEVEL);
 
+    wr_chunk_end();
+
+    wr_chunk_start(SAVE_CHUNK_STORES);
+
     for (auto &store : stores) {
         wr_long((uint32_t) store.turns_left_before_closing);
         wr_short((uint16_t) store.insults_counter);
@@ -254,33 +442,18 @@ static bool sv_write() {
             wr_item(store.inventory[j].item);
         }
     }
+    wr_long(store_maintenance_rng.seed);
 
-    // save the current time in the save file
-    l = getCurrentUnixTime();
-
-    if (l < start_time) {
-        // someone is messing with the clock!,
-        // assume that we have been playing for 1 day
-        l = (uint32_t) (start_time + 86400L);
-    }
-    wr_long(l);
-
-    // put game.character_died_from string in save file
-    wr_string(game.character_died_from);
-
-    // put the max_score in the save file
-    l = (uint32_t) (playerCalculateTotalPoints());
-    wr_long(l);
-
-    // put the date_of_birth in the save file
-    wr_long((uint32_t) py.misc.date_of_birth);
+    wr_chunk_end();
 
     // only level specific info follows, this allows characters to be
     // resurrected, the dungeon level info is not needed for a resurrection
     if (game.character_is_dead) {
-        return !((ferror(fileptr) != 0) || fflush(fileptr) == EOF);
+        return;
     }
 
+    wr_chunk_start(SAVE_CHUNK_LEVEL);
+
     wr_short((uint16_t) dg.current_level);
     wr_short((uint16_t) py.row);
     wr_short((uint16_t) py.col);
@@ -289,68 +462,85 @@ static bool sv_write() {
     wr_short((uint16_t) dg.width);
     wr_short((uint16_t) dg.panel.max_rows);
     wr_short((uint16_t) dg.panel.max_cols);
+    wr_byte(dg.scale);
 
-    for (int i = 0; i < MAX_HEIGHT; i++) {
-        for (int j = 0; j < MAX_WIDTH; j++) {
+    // Only the tiles of the current level are saved,
+    // anything outside of it is blank.
+    for (int i = 0; i < dg.height; i++) {
+        for (int j = 0; j < dg.width; j++) {
             if (dg.floor[i][j].creature_id != 0) {
-                wr_byte((uint8_t) i);
-                wr_byte((uint8_t) j);
-                wr_byte(dg.floor[i][j].creature_id);
+                wr_short((uint16_t) i);
+                wr_short((uint16_t) j);
+                wr_short(dg.floor[i][j].creature_id);
             }
         }
     }
 
     // marks end of creature_id info
-    wr_byte((uint8_t) 0xFF);
+    wr_short((uint16_t) 0xFFFF);
 
-    for (int i = 0; i < MAX_HEIGHT; i++) {
-        for (int j = 0; j < MAX_WIDTH; j++) {
+    for (int i = 0; i < dg.height; i++) {
+        for (int j = 0; j < dg.width; j++) {
             if (dg.floor[i][j].treasure_id != 0) {
-                wr_byte((uint8_t) i);
-                wr_byte((uint8_t) j);
-                wr_byte(dg.floor[i][j].treasure_id);
+                wr_short((uint16_t) i);
+                wr_short((uint16_t) j);
+                wr_short(dg.floor[i][j].treasure_id);
             }
         }
     }
 
     // marks end of treasure_id info
-    wr_byte((uint8_t) 0xFF);
-
-    // must set counter to zero, note that code may write out two bytes unnecessarily
-    int count = 0;
-    uint8_t prev_char = 0;
+    wr_short((uint16_t) 0xFFFF);
 
-    for (int y = 0; y < MAX_HEIGHT; y++) {
-        for (int x = 0; x < MAX_WIDTH; x++) {
-            Tile_t const &tile = dg.floor[y][x];
+    wr_chunk_end();
 
-            auto char_tmp = (uint8_t) (tile.feature_id | (tile.perma_lit_room << 4) | (tile.field_mark << 5) | (tile.permanent_light << 6) | (tile.temporary_light << 7));
+    // The tiles are written one byte each, so they can be read straight
+    // from the file. Older save files have runs of the same tile byte.
+    Floor_t &floor = dg.floor;
 
-            if (char_tmp != prev_char || count == MAX_UCHAR) {
-                wr_byte((uint8_t) count);
-                wr_byte(prev_char);
-                prev_char = char_tmp;
-                count = 1;
-            } else {
-                count++;
+    for (int y = 0; y < dg.height; y++) {
+        if (y % SAVE_FLOOR_BAND_ROWS == 0) {
+            if (y > 0) {
+                wr_chunk_end();
             }
+            wr_chunk_start(floorBandChunkId(y / SAVE_FLOOR_BAND_ROWS));
+        }
+
+        FloorRow_t row = floor[y];
+        uint64_t const *perma_lit_room = floor.perma_lit_room.row(y);
+        uint64_t const *field_mark = floor.field_mark.row(y);
+        uint64_t const *permanent_light = floor.permanent_light.row(y);
+        uint64_t const *temporary_light = floor.temporary_light.row(y);
+
+        uint8_t *tiles = wr_reserve((size_t) dg.width);
+
+        for (int x = 0; x < dg.width; x++) {
+            int word = x >> FLOOR_BITS_SHIFT;
+            int bit = x & FLOOR_BITS_MASK;
+
+            tiles[x] = (uint8_t) (row[x].feature_id | ((perma_lit_room[word] >> bit) & 1u) << 4 | ((field_mark[word] >> bit) & 1u) << 5 | ((permanent_light[word] >> bit) & 1u) << 6 | ((temporary_light[word] >> bit) & 1u) << 7);
         }
     }
 
-    // save last entry
-    wr_byte((uint8_t) count);
-    wr_byte(prev_char);
+    wr_chunk_end();
+
+    wr_chunk_start(SAVE_CHUNK_OBJECTS);
 
     wr_short((uint16_t) current_treasure_id);
     for (int i = config::treasure::MIN_TREASURE_LIST_ID; i < current_treasure_id; i++) {
         wr_item(treasure_list[i]);
     }
+
+    wr_chunk_end();
+
+    wr_chunk_start(SAVE_CHUNK_MONSTERS);
+
     wr_short((uint16_t) next_free_monster_id);
     for (int i = config::monsters::MON_MIN_INDEX_ID; i < next_free_monster_id; i++) {
         wr_monster(monsters[i]);
     }
 
-    return !((ferror(fileptr) != 0) || fflush(fileptr) == EOF);
+    wr_chunk_end();
 }
 
 // Set up prior to actual save, do the save, then clean up
@@ -385,10 +575,21 @@ bool saveGame() {
 }
 
 static bool _save_char(const std::string &filename) {
+    // An autosave still being written must not land on top of this save.
+    autosaveStop();
+
     if (game.character_saved) {
         return true; // Nothing to save.
     }
 
+    // A replay is never saved, as it would overwrite the save file with a
+    // game which is not the player's own. It ends as though it had been.
+    if (replayIsPlaying()) {
+        game.character_saved = true;
+        dg.game_turn = -1;
+        return true;
+    }
+
     putQIO();
     playerDisturb(1, 0);                   // Turn off resting and searching.
     playerChangeSpeed(-py.pack_heaviness); // Fix the speed
@@ -413,22 +614,12 @@ static bool _save_char(const std::string &filename) {
     DEBUG(fprintf(logfile, "Saving data to %s\n", config::files::save_game));
 
     if (fileptr != nullptr) {
-        xor_byte = 0;
-        wr_byte(CURRENT_VERSION_MAJOR);
-        xor_byte = 0;
-        wr_byte(CURRENT_VERSION_MINOR);
-        xor_byte = 0;
-        wr_byte(CURRENT_VERSION_PATCH);
-        xor_byte = 0;
-
-        auto char_tmp = (uint8_t) (randomNumber(256) - 1);
-        wr_byte(char_tmp);
-        // Note that xor_byte is now equal to char_tmp
-
-        ok = sv_write();
+        saveToBuffer();
 
         DEBUG(fclose(logfile));
 
+        ok = fwrite(save_buffer.data(), 1, save_buffer.size(), fileptr) == save_buffer.size();
+
         if (fclose(fileptr) == EOF) {
             ok = false;
         }
@@ -456,10 +647,507 @@ static bool _save_char(const std::string &filename) {
     return true;
 }
 
+// Put the whole save file together in the save buffer. The key is taken from
+// the character, rather than the random number generator, so that saving
+// never changes the course of the game, and a chunk which has not changed
+// comes out the same as last time.
+static void saveToBuffer() {
+    save_buffer.clear();
+    save_key = (uint8_t) py.misc.date_of_birth;
+
+    wr_bytes((uint8_t *) SAVE_FILE_MAGIC, 4);
+    wr_byte(SAVE_FILE_FORMAT);
+    wr_byte(CURRENT_VERSION_MAJOR);
+    wr_byte(CURRENT_VERSION_MINOR);
+    wr_byte(CURRENT_VERSION_PATCH);
+
+    // filled in once the character is saved, as that can change it
+    size_t summary = save_buffer.size();
+    (void) wr_reserve(SAVE_SUMMARY_SIZE);
+
+    sv_write();
+
+    wr_chunk_start(SAVE_CHUNK_SYNC);
+    wr_chunk_end();
+
+    wr_summary(save_buffer.data() + summary);
+}
+
+// Autosaves are put together on the main thread, just as a save is, then
+// handed to a worker thread to write out, so play goes on while the file is
+// written. Only the latest autosave waiting to be written is kept.
+static int32_t autosave_interval = -1; // game turns between autosaves, 0 for new levels only, -1 when off
+static std::thread autosave_thread;
+static std::mutex autosave_mutex;
+static std::condition_variable autosave_ready;
+static std::vector<uint8_t> autosave_buffer; // waiting to be written, empty when there is none
+static std::string autosave_filename;
+static bool autosave_stopping;
+static std::atomic<bool> autosave_failed(false);
+static bool autosave_failure_shown;
+
+// What the worker last wrote to the save file, so that the next autosave
+// only has to append the chunks which are different.
+static std::string journal_filename;
+static std::vector<uint8_t> journal_buffer; // the last save written, empty when there is none
+static size_t journal_size;                 // of the save file, with all that has been appended
+
+void autosaveSetInterval(int32_t turns) {
+    autosave_interval = turns;
+}
+
+// Called at the end of every game turn, and on entering each new level.
+void autosaveCheck(bool new_level) {
+    // a replay must not overwrite the save file of the game it came from
+    if (autosave_interval < 0 || replayIsPlaying()) {
+        return;
+    }
+
+    if (autosave_failed && !autosave_failure_shown) {
+        autosave_failure_shown = true;
+        std::string output = "Autosave to '" + config::files::save_game + "' failed.";
+        printMessage(output.c_str());
+    }
+
+    if (!new_level && (autosave_interval == 0 || dg.game_turn % autosave_interval != 0)) {
+        return;
+    }
+    if (!game.character_generated || game.character_is_dead || game.character_saved || eof_flag != 0) {
+        return;
+    }
+
+    // Never overwrite a save file which this game was not loaded from.
+    if (from_savefile == 0 && access(config::files::save_game.c_str(), 0) >= 0) {
+        return;
+    }
+
+    // Saved with the speed fixed, as _save_char() does, then put back.
+    int16_t pack_heaviness = py.pack_heaviness;
+    uint32_t status = py.flags.status;
+
+    playerChangeSpeed(-pack_heaviness);
+    py.pack_heaviness = 0;
+
+    saveToBuffer();
+
+    playerChangeSpeed(pack_heaviness);
+    py.pack_heaviness = pack_heaviness;
+    py.flags.status = status;
+
+    std::unique_lock<std::mutex> lock(autosave_mutex);
+    autosave_buffer.swap(save_buffer);
+    autosave_filename = config::files::save_game;
+    lock.unlock();
+
+    autosave_ready.notify_one();
+
+    if (!autosave_thread.joinable()) {
+        autosave_stopping = false;
+        autosave_thread = std::thread(autosaveWorker);
+    }
+
+    from_savefile = 1;
+}
+
+// Wait for any autosave being written to finish, dropping one still waiting.
+void autosaveStop() {
+    if (!autosave_thread.joinable()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(autosave_mutex);
+    autosave_stopping = true;
+    autosave_buffer.clear();
+    lock.unlock();
+
+    autosave_ready.notify_one();
+    autosave_thread.join();
+
+    // the save file may be changed by anything from now on
+    journal_buffer.clear();
+}
+
+static void autosaveWorker() {
+    std::vector<uint8_t> bytes;
+    std::string filename;
+
+    std::unique_lock<std::mutex> lock(autosave_mutex);
+
+    while (true) {
+        autosave_ready.wait(lock, [] { return autosave_stopping || !autosave_buffer.empty(); });
+        if (autosave_stopping) {
+            return;
+        }
+
+        bytes.swap(autosave_buffer);
+        autosave_buffer.clear();
+        filename = autosave_filename;
+        lock.unlock();
+
+        if (autosaveAppendChanges(filename, bytes) || autosaveWriteFile(filename, bytes)) {
+            journal_filename = filename;
+            journal_buffer.swap(bytes);
+        } else {
+            journal_buffer.clear();
+            autosave_failed = true;
+        }
+
+        lock.lock();
+    }
+}
+
+// Append the chunks which are different from the last save written, then a
+// SYNC. Saves have the same chunks in the same order, until the size of the
+// level changes or the character dies, when the whole file is written again.
+// So is it once the appended chunks come to more than a whole save, which
+// keeps the file from growing without end.
+static bool autosaveAppendChanges(const std::string &filename, std::vector<uint8_t> const &bytes) {
+    if (journal_buffer.empty() || filename != journal_filename || memcmp(bytes.data(), journal_buffer.data(), SAVE_FILE_PREFIX_SIZE) != 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> changes;
+    size_t sync_offset = 0; // of the SYNC in the changes
+    size_t offset = SAVE_FILE_CHUNKS_OFFSET;
+    size_t last_offset = SAVE_FILE_CHUNKS_OFFSET;
+
+    while (offset < bytes.size()) {
+        if (last_offset >= journal_buffer.size() || getLong(&bytes[offset]) != getLong(&journal_buffer[last_offset])) {
+            return false;
+        }
+
+        size_t end = savedChunkEnd(bytes, offset);
+        size_t last_end = savedChunkEnd(journal_buffer, last_offset);
+
+        // the SYNC at the end is always needed
+        if (end == bytes.size()) {
+            sync_offset = changes.size();
+        }
+        if (end == bytes.size() || end - offset != last_end - last_offset || memcmp(&bytes[offset], &journal_buffer[last_offset], end - offset) != 0) {
+            changes.insert(changes.end(), bytes.begin() + offset, bytes.begin() + end);
+        }
+
+        offset = end;
+        last_offset = last_end;
+    }
+
+    if (last_offset != journal_buffer.size() || journal_size + changes.size() > 2 * bytes.size()) {
+        return false;
+    }
+
+    int flags = O_WRONLY;
+#ifdef _WIN32
+    flags |= O_BINARY;
+#endif
+
+    FILE *file = writeStream(open(filename.c_str(), flags, 0));
+    if (file == nullptr) {
+        return false;
+    }
+
+    // The changed chunks are on the disk before the SYNC which commits them
+    // is written, and the summary with it, so a crash can't leave a SYNC or
+    // a summary for chunks which did not all make it.
+    bool ok = writeAndSync(file, changes.data(), sync_offset, nullptr);
+    ok = ok && writeAndSync(file, changes.data() + sync_offset, changes.size() - sync_offset, bytes.data() + SAVE_FILE_PREFIX_SIZE);
+
+    if (fclose(file) == EOF) {
+        ok = false;
+    }
+
+    if (!ok) {
+        // Whatever did get appended is left out when loading,
+        // as it has no SYNC, and the whole file is written again.
+        return false;
+    }
+
+    journal_size += changes.size();
+
+    return true;
+}
+
+// The whole autosave is written to a temporary file, which is flushed to the
+// disk and then renamed over the save file, so a crash part way through
+// leaves the last save file as it was.
+static bool autosaveWriteFile(const std::string &filename, std::vector<uint8_t> const &bytes) {
+    std::string temp_filename = filename + ".tmp";
+
+    // A temporary file left by a crash is removed, and the new one must then
+    // be created afresh, so that an existing file or a symlink put in its
+    // place is never written through.
+    (void) unlink(temp_filename.c_str());
+
+    int flags = O_WRONLY | O_CREAT | O_EXCL;
+#ifdef _WIN32
+    flags |= O_BINARY;
+#endif
+
+    FILE *file = writeStream(open(temp_filename.c_str(), flags, 0600));
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool ok = writeAndSync(file, bytes.data(), bytes.size(), nullptr);
+
+    if (fclose(file) == EOF) {
+        ok = false;
+    }
+
+#ifdef _WIN32
+    ok = ok && MoveFileExA(temp_filename.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    ok = ok && rename(temp_filename.c_str(), filename.c_str()) == 0;
+#endif
+
+    if (!ok) {
+        (void) unlink(temp_filename.c_str());
+        return false;
+    }
+
+    syncParentDirectory(filename);
+
+    journal_size = bytes.size();
+
+    return true;
+}
+
+// The rename is only lasting once the directory holding the save file is
+// on the disk too. Windows has no way to flush a directory, nor needs one.
+static void syncParentDirectory(const std::string &filename) {
+#ifndef _WIN32
+    size_t slash = filename.find_last_of('/');
+    std::string directory;
+
+    if (slash == std::string::npos) {
+        directory = ".";
+    } else if (slash == 0) {
+        directory = "/";
+    } else {
+        directory = filename.substr(0, slash);
+    }
+
+    int fd = open(directory.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    (void) fsync(fd);
+    (void) close(fd);
+#else
+    (void) filename;
+#endif
+}
+
+// A stream to write the open file with, or null when there is none,
+// in which case the file is closed.
+static FILE *writeStream(int fd) {
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    FILE *file = fdopen(fd, "wb");
+    if (file == nullptr) {
+        (void) close(fd);
+    }
+
+    return file;
+}
+
+// Write to the end of the file, along with a new save summary when given,
+// then flush it to the disk.
+static bool writeAndSync(FILE *file, uint8_t const *bytes, size_t size, uint8_t const *summary) {
+    bool ok = fseek(file, 0, SEEK_END) == 0 && fwrite(bytes, 1, size, file) == size;
+
+    if (summary != nullptr) {
+        ok = ok && fseek(file, (long) SAVE_FILE_PREFIX_SIZE, SEEK_SET) == 0 && fwrite(summary, 1, SAVE_SUMMARY_SIZE, file) == SAVE_SUMMARY_SIZE;
+    }
+
+    ok = ok && fflush(file) == 0;
+
+#ifdef _WIN32
+    ok = ok && _commit(fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+
+    return ok;
+}
+
+// Where the chunk starting at `offset` of a save put together in memory ends,
+// padding and all.
+static size_t savedChunkEnd(std::vector<uint8_t> const &bytes, size_t offset) {
+    size_t end = offset + SAVE_CHUNK_HEADER_SIZE + getLong(&bytes[offset + 4]);
+    return end + (SAVE_CHUNK_ALIGNMENT - end % SAVE_CHUNK_ALIGNMENT) % SAVE_CHUNK_ALIGNMENT;
+}
+
+// A save file found by listSaveFiles(), with its summary.
+typedef struct {
+    std::string filename;
+    uint8_t format; // 0 when not a save file
+    SaveSummary_t summary;
+} SaveListing_t;
+
+// Only the prefix and summary at the start of the file are read.
+static void readSaveListing(const std::string &directory, SaveListing_t &listing) {
+    uint8_t bytes[SAVE_FILE_CHUNKS_OFFSET];
+
+    int flags = O_RDONLY;
+#ifdef _WIN32
+    flags |= O_BINARY;
+#endif
+
+    int fd = open((directory + "/" + listing.filename).c_str(), flags, 0);
+    if (fd < 0) {
+        return;
+    }
+
+#ifdef _WIN32
+    long size = (long) read(fd, bytes, sizeof bytes);
+#else
+    long size = (long) pread(fd, bytes, sizeof bytes, 0);
+#endif
+
+    (void) close(fd);
+
+    if (size < (long) SAVE_FILE_PREFIX_SIZE || memcmp(bytes, SAVE_FILE_MAGIC, 4) != 0) {
+        return;
+    }
+
+    listing.format = bytes[4];
+
+    if (listing.format > 3 && size == (long) sizeof bytes) {
+        rd_summary(bytes + SAVE_FILE_PREFIX_SIZE, listing.summary);
+    }
+}
+
+// The summary is neither encrypted nor checked, so anyone able to write a
+// save file could put terminal escape codes in it, as could a file name.
+static std::string printableText(const std::string &text) {
+    std::string printable = text;
+
+    for (auto &ch : printable) {
+        if (ch < ' ' || ch > '~') {
+            ch = '?';
+        }
+    }
+
+    return printable;
+}
+
+// List the characters of the save files in a directory, reading the files
+// on as many threads as there are processors.
+bool listSaveFiles(const std::string &directory) {
+    std::vector<std::string> filenames;
+    if (!readDirectory(directory, filenames)) {
+        printf("Unable to read the directory: %s\n", directory.c_str());
+        return false;
+    }
+    std::sort(filenames.begin(), filenames.end());
+
+    std::vector<SaveListing_t> listings;
+    for (auto const &filename : filenames) {
+        SaveListing_t listing{};
+        listing.filename = filename;
+        listings.push_back(listing);
+    }
+
+    size_t threads = std::thread::hardware_concurrency();
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (threads > listings.size()) {
+        threads = listings.size();
+    }
+
+    std::atomic<size_t> next_listing(0);
+    std::vector<std::thread> readers;
+
+    for (size_t i = 0; i < threads; i++) {
+        readers.emplace_back([&]() {
+            for (size_t id = next_listing++; id < listings.size(); id = next_listing++) {
+                readSaveListing(directory, listings[id]);
+            }
+        });
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+
+    printf("%-20s %-19s %3s %-10s %-7s %5s %8s  %s\n", "Save File", "Name", "Lvl", "Race", "Class", "Depth", "Points", "Status");
+
+    for (auto const &listing : listings) {
+        if (listing.format == 0) {
+            continue;
+        }
+
+        SaveSummary_t const &summary = listing.summary;
+        std::string filename = printableText(listing.filename);
+
+        if (listing.format < 4) {
+            printf("%-20.20s %s\n", filename.c_str(), "(an older save file, with no summary)");
+            continue;
+        }
+
+        const char *race = summary.race < PLAYER_MAX_RACES ? character_races[summary.race].name : "?";
+        const char *title = summary.character_class < PLAYER_MAX_CLASSES ? classes[summary.character_class].title : "?";
+
+        std::string depth = summary.dungeon_depth == 0 ? "town" : std::to_string(summary.dungeon_depth * 50) + "ft";
+
+        std::string status;
+        if (summary.dead) {
+            status = std::string("killed by ") + summary.died_from;
+        } else if (summary.total_winner) {
+            status = "total winner";
+        } else {
+            status = "alive";
+        }
+
+        std::string name = printableText(summary.name);
+        status = printableText(status);
+
+        printf("%-20.20s %-19.19s %3d %-10.10s %-7.7s %5s %8d  %s\n", filename.c_str(), name.c_str(), summary.level, race, title, depth.c_str(), summary.points, status.c_str());
+    }
+
+    return true;
+}
+
+static bool readDirectory(const std::string &directory, std::vector<std::string> &filenames) {
+#ifdef _WIN32
+    WIN32_FIND_DATAA entry;
+
+    HANDLE find = FindFirstFileA((directory + "\\*").c_str(), &entry);
+    if (find == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    do {
+        if ((entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+            filenames.push_back(entry.cFileName);
+        }
+    } while (FindNextFileA(find, &entry) != 0);
+
+    (void) FindClose(find);
+#else
+    DIR *dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+        return false;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        if (entry->d_name[0] != '.') {
+            filenames.push_back(entry->d_name);
+        }
+    }
+
+    (void) closedir(dir);
+#endif
+
+    return true;
+}
+
 // Certain checks are omitted for the wizard. -CJS-
 bool loadGame(bool &generate) {
-    Tile_t *tile = nullptr;
-    int c;
     uint32_t time_saved = 0;
     uint8_t version_maj = 0;
     uint8_t version_min = 0;
@@ -497,7 +1185,7 @@ bool loadGame(bool &generate) {
         fd = -1; // Make sure it isn't closed again
         fileptr = fopen(config::files::save_game.c_str(), "rb");
 
-        if (fileptr == nullptr) {
+        if (fileptr == nullptr || !readSaveFile(version_maj, version_min, patch_level)) {
             goto error;
         }
 
@@ -507,16 +1195,6 @@ bool loadGame(bool &generate) {
         DEBUG(logfile = fopen("IO_LOG", "a"));
         DEBUG(fprintf(logfile, "Reading data from %s\n", config::files::save_game));
 
-        // Note: setting these xor_byte is correct!
-        xor_byte = 0;
-        version_maj = rd_byte();
-        xor_byte = 0;
-        version_min = rd_byte();
-        xor_byte = 0;
-        patch_level = rd_byte();
-
-        xor_byte = get_byte();
-
         if (!validGameVersion(version_maj, version_min, patch_level)) {
             putStringClearToEOL("Sorry. This save file is from a different version of umoria.", Coord_t{2, 0});
             goto error;
@@ -525,6 +1203,10 @@ bool loadGame(bool &generate) {
         uint16_t uint16_t_tmp;
         uint32_t l;
 
+        if (!rd_chunk(SAVE_CHUNK_RECALL)) {
+            goto error;
+        }
+
         uint16_t_tmp = rd_short();
         while (uint16_t_tmp != 0xFFFF) {
             if (uint16_t_tmp >= MON_MAX_CREATURES) {
@@ -542,6 +1224,10 @@ bool loadGame(bool &generate) {
             uint16_t_tmp = rd_short();
         }
 
+        if (!rd_chunk(SAVE_CHUNK_PLAYER)) {
+            goto error;
+        }
+
         l = rd_long();
 
         config::options::run_cut_corners = (l & 0x1) != 0;
@@ -659,6 +1345,11 @@ bool loadGame(bool &generate) {
 
             missiles_counter = rd_short();
             dg.game_turn = rd_long();
+
+            if (!rd_chunk(SAVE_CHUNK_INVENTORY)) {
+                goto error;
+            }
+
             py.unique_inventory_items = rd_short();
             if (py.unique_inventory_items > player_equipment::EQUIPMENT_WIELD) {
                 goto error;
@@ -671,6 +1362,11 @@ bool loadGame(bool &generate) {
             }
             py.inventory_weight = rd_short();
             py.equipment_count = rd_short();
+
+            if (!rd_chunk(SAVE_CHUNK_GAME)) {
+                goto error;
+            }
+
             py.flags.spells_learnt = rd_long();
             py.flags.spells_worked = rd_long();
             py.flags.spells_forgotten = rd_long();
@@ -693,6 +1389,10 @@ bool loadGame(bool &generate) {
             game.noscore = rd_short();
             rd_shorts(py.base_hp_levels, PLAYER_MAX_LEVEL);
 
+            if (!rd_chunk(SAVE_CHUNK_STORES)) {
+                goto error;
+            }
+
             for (auto &store : stores) {
                 store.turns_left_before_closing = rd_long();
                 store.insults_counter = rd_short();
@@ -709,14 +1409,26 @@ bool loadGame(bool &generate) {
                 }
             }
 
+            storeMaintenanceInitialize();
+            if ((l & 0x08000000L) != 0) {
+                store_maintenance_rng.seed = rd_long();
+            }
+
+            if (!rd_chunk(SAVE_CHUNK_HEADER)) {
+                goto error;
+            }
+
             time_saved = rd_long();
             rd_string(game.character_died_from);
             py.max_score = rd_long();
             py.misc.date_of_birth = rd_long();
         }
 
-        c = getc(fileptr);
-        if (c == EOF || ((l & 0x80000000L) != 0)) {
+        if (read_error) {
+            goto error;
+        }
+
+        if (!rd_chunk(SAVE_CHUNK_LEVEL) || ((l & 0x80000000L) != 0)) {
             if ((l & 0x80000000L) == 0) {
                 if (!game.to_be_wizard || dg.game_turn < 0) {
                     goto error;
@@ -752,9 +1464,6 @@ bool loadGame(bool &generate) {
             putQIO();
             goto closefiles;
         }
-        if (ungetc(c, fileptr) == EOF) {
-            goto error;
-        }
 
         putStringClearToEOL("Restoring Character...", Coord_t{0, 0});
         putQIO();
@@ -771,52 +1480,143 @@ bool loadGame(bool &generate) {
         dg.panel.max_rows = rd_short();
         dg.panel.max_cols = rd_short();
 
-        uint8_t char_tmp, ychar, xchar, count;
+        uint8_t char_tmp, count;
+        uint16_t ychar, xchar, tile_id;
+        bool wide_tile_ids, wide_coordinates;
+        int saved_height, saved_width;
+
+        // older save files have the tile ids as bytes
+        wide_tile_ids = (l & 0x20000000L) != 0;
+
+        // older save files have byte coordinates, and all the
+        // tiles of a normal sized dungeon, whatever the level
+        wide_coordinates = (l & 0x10000000L) != 0;
+
+        if (wide_coordinates) {
+            dungeonSetScale(rd_byte());
+            saved_height = dg.height;
+            saved_width = dg.width;
+        } else {
+            dungeonSetScale(1);
+            saved_height = DUNGEON_HEIGHT;
+            saved_width = DUNGEON_WIDTH;
+        }
+        if (saved_height > dg.floor.height || saved_width > dg.floor.width) {
+            goto error;
+        }
 
         // read in the creature ptr info
-        char_tmp = rd_byte();
-        while (char_tmp != 0xFF) {
-            ychar = char_tmp;
-            xchar = rd_byte();
-            char_tmp = rd_byte();
-            if (xchar > MAX_WIDTH || ychar > MAX_HEIGHT) {
+        ychar = wide_coordinates ? rd_short() : rd_byte();
+        while (ychar != (wide_coordinates ? 0xFFFF : 0xFF)) {
+            xchar = wide_coordinates ? rd_short() : rd_byte();
+            tile_id = wide_tile_ids ? rd_short() : rd_byte();
+            if (xchar >= saved_width || ychar >= saved_height || tile_id >= MON_TOTAL_ALLOCATIONS) {
                 goto error;
             }
-            dg.floor[ychar][xchar].creature_id = char_tmp;
-            char_tmp = rd_byte();
+            dg.floor[ychar][xchar].creature_id = tile_id;
+            ychar = wide_coordinates ? rd_short() : rd_byte();
         }
 
         // read in the treasure ptr info
-        char_tmp = rd_byte();
-        while (char_tmp != 0xFF) {
-            ychar = char_tmp;
-            xchar = rd_byte();
-            char_tmp = rd_byte();
-            if (xchar > MAX_WIDTH || ychar > MAX_HEIGHT) {
+        ychar = wide_coordinates ? rd_short() : rd_byte();
+        while (ychar != (wide_coordinates ? 0xFFFF : 0xFF)) {
+            xchar = wide_coordinates ? rd_short() : rd_byte();
+            tile_id = wide_tile_ids ? rd_short() : rd_byte();
+            if (xchar >= saved_width || ychar >= saved_height || tile_id >= LEVEL_MAX_OBJECTS) {
                 goto error;
             }
-            dg.floor[ychar][xchar].treasure_id = char_tmp;
-            char_tmp = rd_byte();
+            dg.floor[ychar][xchar].treasure_id = tile_id;
+            ychar = wide_coordinates ? rd_short() : rd_byte();
+        }
+
+        // read in the rest of the cave info, where the floor flags start off
+        // clear, so only need setting for the tiles which have them
+        if (chunked_file) {
+            // one byte for each tile, read straight from the file
+            for (int y = 0; y < saved_height; y++) {
+                if (file_format > 2 && y % SAVE_FLOOR_BAND_ROWS == 0 && !rd_chunk(floorBandChunkId(y / SAVE_FLOOR_BAND_ROWS))) {
+                    goto error;
+                }
+
+                uint8_t const *row_tiles = rd_view((size_t) saved_width);
+                if (row_tiles == nullptr) {
+                    goto error;
+                }
+
+                FloorRow_t row = dg.floor[y];
+                for (int x = 0; x < saved_width; x++) {
+                    row[x].feature_id = (uint8_t) (row_tiles[x] & 0xF);
+                }
+
+                // the flags are put together a word at a time
+                for (int left = 0; left < saved_width; left += FLOOR_BITS_MASK + 1) {
+                    int word = left >> FLOOR_BITS_SHIFT;
+                    int right = left + FLOOR_BITS_MASK < saved_width ? left + FLOOR_BITS_MASK : saved_width - 1;
+                    uint64_t perma_lit_room = 0;
+                    uint64_t field_mark = 0;
+                    uint64_t permanent_light = 0;
+                    uint64_t temporary_light = 0;
+
+                    for (int x = left; x <= right; x++) {
+                        uint64_t tile = row_tiles[x];
+                        int bit = x - left;
+
+                        perma_lit_room |= ((tile >> 4) & 1u) << bit;
+                        field_mark |= ((tile >> 5) & 1u) << bit;
+                        permanent_light |= ((tile >> 6) & 1u) << bit;
+                        temporary_light |= ((tile >> 7) & 1u) << bit;
+                    }
+
+                    dg.floor.perma_lit_room.row(y)[word] |= perma_lit_room;
+                    dg.floor.field_mark.row(y)[word] |= field_mark;
+                    dg.floor.permanent_light.row(y)[word] |= permanent_light;
+                    dg.floor.temporary_light.row(y)[word] |= temporary_light;
+                }
+            }
         }
 
-        // read in the rest of the cave info
-        tile = &dg.floor[0][0];
+        // older save files have runs of the same tile byte, where each
+        // run only needs its flags setting for each part along a row
         total_count = 0;
-        while (total_count != MAX_HEIGHT * MAX_WIDTH) {
+        while (!chunked_file && total_count != saved_height * saved_width) {
             count = rd_byte();
             char_tmp = rd_byte();
-            for (int i = count; i > 0; i--) {
-                if (tile >= &dg.floor[MAX_HEIGHT][0]) {
-                    goto error;
+            if (total_count + count > saved_height * saved_width) {
+                goto error;
+            }
+
+            int remaining = count;
+            while (remaining > 0) {
+                int y = total_count / saved_width;
+                int x = total_count % saved_width;
+                int run = remaining < saved_width - x ? remaining : saved_width - x;
+
+                for (int i = x; i < x + run; i++) {
+                    dg.floor[y][i].feature_id = (uint8_t) (char_tmp & 0xF);
+                }
+                if (((char_tmp >> 4) & 0x1) != 0) {
+                    floorBitsSetRange(dg.floor.perma_lit_room, y, x, x + run - 1);
+                }
+                if (((char_tmp >> 5) & 0x1) != 0) {
+                    floorBitsSetRange(dg.floor.field_mark, y, x, x + run - 1);
+                }
+                if (((char_tmp >> 6) & 0x1) != 0) {
+                    floorBitsSetRange(dg.floor.permanent_light, y, x, x + run - 1);
                 }
-                tile->feature_id = (uint8_t) (char_tmp & 0xF);
-                tile->perma_lit_room = (bool) ((char_tmp >> 4) & 0x1);
-                tile->field_mark = (bool) ((char_tmp >> 5) & 0x1);
-                tile->permanent_light = (bool) ((char_tmp >> 6) & 0x1);
-                tile->temporary_light = (bool) ((char_tmp >> 7) & 0x1);
-                tile++;
+                if (((char_tmp >> 7) & 0x1) != 0) {
+                    floorBitsSetRange(dg.floor.temporary_light, y, x, x + run - 1);
+                }
+
+                total_count += run;
+                remaining -= run;
             }
-            total_count += count;
+        }
+
+        // the rooms are not saved, but found again from their tiles
+        dungeonLabelRegions();
+
+        if (!rd_chunk(SAVE_CHUNK_OBJECTS)) {
+            goto error;
         }
 
         current_treasure_id = rd_short();
@@ -826,17 +1626,24 @@ bool loadGame(bool &generate) {
         for (int i = config::treasure::MIN_TREASURE_LIST_ID; i < current_treasure_id; i++) {
             rd_item(treasure_list[i]);
         }
+        treasureLocationsRebuild();
+        losCacheInvalidate();
+        if (!rd_chunk(SAVE_CHUNK_MONSTERS)) {
+            goto error;
+        }
+
         next_free_monster_id = rd_short();
         if (next_free_monster_id > MON_TOTAL_ALLOCATIONS) {
             goto error;
         }
         for (int i = config::monsters::MON_MIN_INDEX_ID; i < next_free_monster_id; i++) {
-            rd_monster(monsters[i]);
+            rd_monster(monsters[i], wide_coordinates);
         }
+        monsterIndexRebuild();
 
         generate = false; // We have restored a cave - no need to generate.
 
-        if (ferror(fileptr) != 0) {
+        if (read_error) {
             goto error;
         }
 
@@ -855,6 +1662,8 @@ bool loadGame(bool &generate) {
 
         DEBUG(fclose(logfile));
 
+        closeSaveFile();
+
         if (fileptr != nullptr) {
             if (fclose(fileptr) < 0) {
                 ok = false;
@@ -883,7 +1692,7 @@ bool loadGame(bool &generate) {
                 playerStrength();
 
                 // rotate store inventory, depending on how old the save file
-                // is foreach day old (rounded up), call storeMaintenance
+                // is foreach day old (rounded up), call storeMaintenanceDue
                 // calculate age in seconds
                 start_time = getCurrentUnixTime();
 
@@ -902,7 +1711,7 @@ bool loadGame(bool &generate) {
                 }
 
                 for (int i = 0; i < (int) age; i++) {
-                    storeMaintenance();
+                    storeMaintenanceDue();
                 }
             }
 
@@ -933,78 +1742,403 @@ bool loadGame(bool &generate) {
     return false; // not reached
 }
 
+// Saves are encrypted by xor'ing each byte with the file byte before it. The
+// first byte is the encryption key, which is written as it is.
+static void xorChainEncode(uint8_t *bytes, size_t size) {
+    for (size_t i = 1; i < size; i++) {
+        bytes[i] ^= bytes[i - 1];
+    }
+}
+
+// Decrypting only needs each file byte and the one before it, so is done
+// from the end back, with no chain from one byte to the next.
+static void xorChainDecode(uint8_t *bytes, size_t size) {
+    for (size_t i = size; i > 1; i--) {
+        bytes[i - 1] ^= bytes[i - 2];
+    }
+}
+
+// Adler-32 checksum of the chunk data, as written to the file. The sums are
+// only reduced every 5552 bytes, the most which can be added without them
+// overflowing.
+static uint32_t saveChecksum(uint8_t const *bytes, size_t size) {
+    uint32_t a = 1;
+    uint32_t b = 0;
+
+    while (size > 0) {
+        size_t block = size < 5552 ? size : 5552;
+        size -= block;
+
+        for (size_t i = 0; i < block; i++) {
+            a += bytes[i];
+            b += a;
+        }
+        bytes += block;
+
+        a %= 65521;
+        b %= 65521;
+    }
+
+    return b << 16 | a;
+}
+
+static uint32_t getLong(uint8_t const *bytes) {
+    return (uint32_t) bytes[0] | (uint32_t) bytes[1] << 8 | (uint32_t) bytes[2] << 16 | (uint32_t) bytes[3] << 24;
+}
+
+static void setLong(uint8_t *bytes, uint32_t value) {
+    bytes[0] = (uint8_t) (value & 0xFF);
+    bytes[1] = (uint8_t) ((value >> 8) & 0xFF);
+    bytes[2] = (uint8_t) ((value >> 16) & 0xFF);
+    bytes[3] = (uint8_t) ((value >> 24) & 0xFF);
+}
+
+static uint16_t getShort(uint8_t const *bytes) {
+    return (uint16_t) (bytes[0] | bytes[1] << 8);
+}
+
+static void setShort(uint8_t *bytes, uint16_t value) {
+    bytes[0] = (uint8_t) (value & 0xFF);
+    bytes[1] = (uint8_t) ((value >> 8) & 0xFF);
+}
+
+// The save file summary, which is all a listing of the save files reads:
+//
+//   0: save time, 4: points, 8: level, 10: dungeon depth, 12: deepest depth,
+//   14: race, 15: class, 16: flags (1: dead, 2: total winner), 17: unused,
+//   18: name, 45: died from, 70: unused
+static void wr_summary(uint8_t *bytes) {
+    memset(bytes, 0, SAVE_SUMMARY_SIZE);
+
+    setLong(bytes, getCurrentUnixTime());
+    setLong(bytes + 4, (uint32_t) playerCalculateTotalPoints());
+    setShort(bytes + 8, py.misc.level);
+    setShort(bytes + 10, (uint16_t) dg.current_level);
+    setShort(bytes + 12, py.misc.max_dungeon_depth);
+    bytes[14] = py.misc.race_id;
+    bytes[15] = py.misc.class_id;
+    bytes[16] = (uint8_t) ((game.character_is_dead ? 0x1 : 0) | (game.total_winner ? 0x2 : 0));
+    (void) snprintf((char *) bytes + 18, PLAYER_NAME_SIZE, "%s", py.misc.name);
+    (void) snprintf((char *) bytes + 45, 25, "%.24s", game.character_died_from);
+}
+
+static void rd_summary(uint8_t const *bytes, SaveSummary_t &summary) {
+    summary.time_saved = getLong(bytes);
+    summary.points = (int32_t) getLong(bytes + 4);
+    summary.level = getShort(bytes + 8);
+    summary.dungeon_depth = getShort(bytes + 10);
+    summary.deepest_dungeon_depth = getShort(bytes + 12);
+    summary.race = bytes[14];
+    summary.character_class = bytes[15];
+    summary.dead = (bytes[16] & 0x1) != 0;
+    summary.total_winner = (bytes[16] & 0x2) != 0;
+
+    memcpy(summary.name, bytes + 18, PLAYER_NAME_SIZE);
+    summary.name[PLAYER_NAME_SIZE - 1] = '\0';
+    memcpy(summary.died_from, bytes + 45, 25);
+    summary.died_from[24] = '\0';
+}
+
+// Start a chunk, the data of which is everything written up to wr_chunk_end().
+static void wr_chunk_start(uint32_t id) {
+    chunk_start = save_buffer.size();
+
+    wr_long(id);
+    wr_long(0); // size and checksum, filled in by wr_chunk_end()
+    wr_long(0);
+    wr_byte(0);
+    wr_byte(0);
+    wr_byte(0);
+    wr_byte(save_key);
+}
+
+static void wr_chunk_end() {
+    uint8_t *chunk = save_buffer.data() + chunk_start;
+    size_t size = save_buffer.size() - chunk_start - SAVE_CHUNK_HEADER_SIZE;
+
+    // the key is the last byte of the chunk header
+    xorChainEncode(chunk + SAVE_CHUNK_HEADER_SIZE - 1, size + 1);
+
+    setLong(chunk + 4, (uint32_t) size);
+    setLong(chunk + 8, saveChecksum(chunk + SAVE_CHUNK_HEADER_SIZE, size));
+
+    while (save_buffer.size() % SAVE_CHUNK_ALIGNMENT != 0) {
+        save_buffer.push_back(0);
+    }
+}
+
+// Map the whole save file into memory, or where that can't be done, read it
+// into the save buffer. Mapped pages are private, so decrypting in place
+// leaves the file alone.
+static bool loadSaveFileBytes() {
+    file_bytes = nullptr;
+    file_size = 0;
+    file_mapped = false;
+
+#ifndef _WIN32
+    struct stat file_status {};
+
+    if (fstat(fileno(fileptr), &file_status) == 0 && file_status.st_size > 0) {
+        int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        // all of the file is read, so fault in all the pages in one go
+        flags |= MAP_POPULATE;
+#endif
+        void *mapping = mmap(nullptr, (size_t) file_status.st_size, PROT_READ | PROT_WRITE, flags, fileno(fileptr), 0);
+
+        if (mapping != MAP_FAILED) {
+            file_bytes = (uint8_t *) mapping;
+            file_size = (size_t) file_status.st_size;
+            file_mapped = true;
+            return true;
+        }
+    }
+#endif
+
+    if (fseek(fileptr, 0, SEEK_END) != 0) {
+        return false;
+    }
+
+    long size = ftell(fileptr);
+    if (size < 0 || fseek(fileptr, 0, SEEK_SET) != 0) {
+        return false;
+    }
+
+    save_buffer.resize((size_t) size);
+    if (fread(save_buffer.data(), 1, save_buffer.size(), fileptr) != save_buffer.size()) {
+        return false;
+    }
+
+    file_bytes = save_buffer.data();
+    file_size = save_buffer.size();
+
+    return true;
+}
+
+// Get the save file ready for the rd_* functions, and its game version.
+// The chunks of a save file are found, but only checked and decrypted
+// when they are read. Older save files are decrypted in one go.
+static bool readSaveFile(uint8_t &version_maj, uint8_t &version_min, uint8_t &patch_level) {
+    file_chunks.clear();
+    chunked_file = false;
+    read_bytes = nullptr;
+    read_size = 0;
+    read_pos = 0;
+    read_error = false;
+
+    if (!loadSaveFileBytes()) {
+        return false;
+    }
+
+    if (file_size >= SAVE_FILE_PREFIX_SIZE && memcmp(file_bytes, SAVE_FILE_MAGIC, 4) == 0) {
+        file_format = file_bytes[4];
+        if (file_format < 2 || file_format > SAVE_FILE_FORMAT) {
+            return false;
+        }
+
+        version_maj = file_bytes[5];
+        version_min = file_bytes[6];
+        patch_level = file_bytes[7];
+
+        size_t offset = file_format > 3 ? SAVE_FILE_CHUNKS_OFFSET : SAVE_FILE_PREFIX_SIZE;
+        std::vector<size_t> syncs; // the number of chunks up to each SYNC
+
+        while (offset < file_size) {
+            // an append cut short, which is left out along with the rest
+            // of its chunks, as the SYNC never made it to the file
+            if (file_size - offset < SAVE_CHUNK_HEADER_SIZE || getLong(file_bytes + offset + 4) > file_size - offset - SAVE_CHUNK_HEADER_SIZE) {
+                if (file_format == 2) {
+                    return false;
+                }
+                break;
+            }
+
+            SaveChunk_t chunk{};
+            chunk.id = getLong(file_bytes + offset);
+            chunk.size = getLong(file_bytes + offset + 4);
+            chunk.checksum = getLong(file_bytes + offset + 8);
+            chunk.offset = offset + SAVE_CHUNK_HEADER_SIZE;
+            file_chunks.push_back(chunk);
+
+            if (chunk.id == SAVE_CHUNK_SYNC) {
+                syncs.push_back(file_chunks.size());
+            }
+
+            offset = chunk.offset + chunk.size;
+            offset += (SAVE_CHUNK_ALIGNMENT - offset % SAVE_CHUNK_ALIGNMENT) % SAVE_CHUNK_ALIGNMENT;
+        }
+
+        // A crash while appending can leave a SYNC after chunks which never
+        // all made it to the disk. So the chunks before the last SYNC are
+        // checked now, going back a SYNC at a time until they are all whole,
+        // which loses one autosave rather than the game. Chunks before that
+        // were on the disk before the SYNC after them was written.
+        if (file_format > 2) {
+            size_t synced_chunks = 0;
+
+            for (size_t i = syncs.size(); i > 0 && synced_chunks == 0; i--) {
+                bool whole = true;
+                for (size_t id = i > 1 ? syncs[i - 2] : 0; id < syncs[i - 1] && whole; id++) {
+                    whole = decryptChunk(file_chunks[id]);
+                }
+                if (whole) {
+                    synced_chunks = syncs[i - 1];
+                }
+            }
+
+            if (synced_chunks == 0) {
+                return false;
+            }
+            file_chunks.resize(synced_chunks);
+        }
+
+        chunked_file = true;
+        return true;
+    }
+
+    // Older save files start with the game version and then the encryption
+    // key, which are not encrypted.
+    if (file_size < 4) {
+        return false;
+    }
+
+    version_maj = file_bytes[0];
+    version_min = file_bytes[1];
+    patch_level = file_bytes[2];
+
+    xorChainDecode(file_bytes + 3, file_size - 3);
+
+    read_bytes = file_bytes;
+    read_size = file_size;
+    read_pos = 4;
+
+    return true;
+}
+
+static void closeSaveFile() {
+#ifndef _WIN32
+    if (file_mapped) {
+        (void) munmap(file_bytes, file_size);
+    }
+#endif
+
+    file_bytes = nullptr;
+    file_size = 0;
+    file_mapped = false;
+    file_chunks.clear();
+
+    read_bytes = nullptr;
+    read_size = 0;
+    read_pos = 0;
+}
+
+// Check a chunk against its checksum and decrypt it in place, the first time.
+static bool decryptChunk(SaveChunk_t &chunk) {
+    if (chunk.decrypted) {
+        return true;
+    }
+
+    uint8_t *data = file_bytes + chunk.offset;
+
+    if (saveChecksum(data, chunk.size) != chunk.checksum) {
+        return false;
+    }
+    xorChainDecode(data - 1, chunk.size + 1);
+    chunk.decrypted = true;
+
+    return true;
+}
+
+// Read the chunk with the given id from now on, checking and decrypting it
+// first. Older save files carry straight on from one part to the next, so
+// for them this is just a check that there is more to read.
+static bool rd_chunk(uint32_t id) {
+    if (!chunked_file) {
+        return read_pos < read_size;
+    }
+
+    // the last chunk with the id is the latest
+    for (size_t i = file_chunks.size(); i > 0; i--) {
+        SaveChunk_t &chunk = file_chunks[i - 1];
+        if (chunk.id != id) {
+            continue;
+        }
+
+        if (!decryptChunk(chunk)) {
+            read_error = true;
+            return false;
+        }
+
+        read_bytes = file_bytes + chunk.offset;
+        read_size = chunk.size;
+        read_pos = 0;
+
+        return true;
+    }
+
+    return false;
+}
+
+// The next `size` bytes, read in place rather than copied out.
+static uint8_t const *rd_view(size_t size) {
+    if (read_size - read_pos < size) {
+        read_error = true;
+        return nullptr;
+    }
+
+    uint8_t const *view = read_bytes + read_pos;
+    read_pos += size;
+
+    return view;
+}
+
+// Room for the next `size` bytes, to be filled in place.
+static uint8_t *wr_reserve(size_t size) {
+    size_t start = save_buffer.size();
+    save_buffer.resize(start + size);
+    return save_buffer.data() + start;
+}
+
 static void wr_bool(bool value) {
     wr_byte((uint8_t) value);
 }
 
 static void wr_byte(uint8_t value) {
-    xor_byte ^= value;
-    (void) putc((int) xor_byte, fileptr);
-    DEBUG(fprintf(logfile, "BYTE:  %02X = %d\n", (int) xor_byte, (int) value));
+    save_buffer.push_back(value);
+    DEBUG(fprintf(logfile, "BYTE:  %d\n", (int) value));
 }
 
 static void wr_short(uint16_t value) {
-    xor_byte ^= (value & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
-    DEBUG(fprintf(logfile, "SHORT: %02X", (int) xor_byte));
-    xor_byte ^= ((value >> 8) & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
-    DEBUG(fprintf(logfile, " %02X = %d\n", (int) xor_byte, (int) value));
+    save_buffer.push_back((uint8_t) (value & 0xFF));
+    save_buffer.push_back((uint8_t) ((value >> 8) & 0xFF));
+    DEBUG(fprintf(logfile, "SHORT: %d\n", (int) value));
 }
 
 static void wr_long(uint32_t value) {
-    xor_byte ^= (value & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
-    DEBUG(fprintf(logfile, "LONG:  %02X", (int) xor_byte));
-    xor_byte ^= ((value >> 8) & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
-    DEBUG(fprintf(logfile, " %02X", (int) xor_byte));
-    xor_byte ^= ((value >> 16) & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
-    DEBUG(fprintf(logfile, " %02X", (int) xor_byte));
-    xor_byte ^= ((value >> 24) & 0xFF);
-    (void) putc((int) xor_byte, fileptr);
-    DEBUG(fprintf(logfile, " %02X = %ld\n", (int) xor_byte, (int32_t) value));
+    save_buffer.push_back((uint8_t) (value & 0xFF));
+    save_buffer.push_back((uint8_t) ((value >> 8) & 0xFF));
+    save_buffer.push_back((uint8_t) ((value >> 16) & 0xFF));
+    save_buffer.push_back((uint8_t) ((value >> 24) & 0xFF));
+    DEBUG(fprintf(logfile, "LONG:  %ld\n", (int32_t) value));
 }
 
 static void wr_bytes(uint8_t *value, int count) {
-    uint8_t *ptr;
-
     DEBUG(fprintf(logfile, "%d BYTES:", count));
-    ptr = value;
-    for (int i = 0; i < count; i++) {
-        xor_byte ^= *ptr++;
-        (void) putc((int) xor_byte, fileptr);
-        DEBUG(fprintf(logfile, "  %02X = %d", (int) xor_byte, (int) (ptr[-1])));
-    }
+    save_buffer.insert(save_buffer.end(), value, value + count);
     DEBUG(fprintf(logfile, "\n"));
 }
 
 static void wr_string(char *str) {
-    DEBUG(char *s = str);
-    DEBUG(fprintf(logfile, "STRING:"));
-    while (*str != '\0') {
-        xor_byte ^= *str++;
-        (void) putc((int) xor_byte, fileptr);
-        DEBUG(fprintf(logfile, " %02X", (int) xor_byte));
-    }
-    xor_byte ^= *str;
-    (void) putc((int) xor_byte, fileptr);
-    DEBUG(fprintf(logfile, " %02X = \"%s\"\n", (int) xor_byte, s));
+    DEBUG(fprintf(logfile, "STRING: \"%s\"\n", str));
+    do {
+        save_buffer.push_back((uint8_t) *str);
+    } while (*str++ != '\0');
 }
 
 static void wr_shorts(uint16_t *value, int count) {
     DEBUG(fprintf(logfile, "%d SHORTS:", count));
-
-    uint16_t *sptr = value;
-
     for (int i = 0; i < count; i++) {
-        xor_byte ^= (*sptr & 0xFF);
-        (void) putc((int) xor_byte, fileptr);
-        DEBUG(fprintf(logfile, "  %02X", (int) xor_byte));
-        xor_byte ^= ((*sptr++ >> 8) & 0xFF);
-        (void) putc((int) xor_byte, fileptr);
-        DEBUG(fprintf(logfile, " %02X = %d", (int) xor_byte, (int) sptr[-1]));
+        wr_short(value[i]);
     }
     DEBUG(fprintf(logfile, "\n"));
 }
@@ -1038,17 +2172,22 @@ static void wr_monster(Monster_t const &monster) {
     wr_short((uint16_t) monster.sleep_count);
     wr_short((uint16_t) monster.speed);
     wr_short(monster.creature_id);
-    wr_byte(monster.y);
-    wr_byte(monster.x);
+    wr_short(monster.y);
+    wr_short(monster.x);
     wr_byte(monster.distance_from_player);
     wr_bool(monster.lit);
     wr_byte(monster.stunned_amount);
     wr_byte(monster.confused_amount);
 }
 
-// get_byte reads a single byte from a file, without any xor_byte encryption
+// get_byte takes the next byte of what is being read, which has already been
+// decrypted. Reading past the end is flagged by `read_error`.
 static uint8_t get_byte() {
-    return (uint8_t) (getc(fileptr) & 0xFF);
+    if (read_pos >= read_size) {
+        read_error = true;
+        return 0;
+    }
+    return read_bytes[read_pos++];
 }
 
 static bool rd_bool() {
@@ -1056,80 +2195,48 @@ static bool rd_bool() {
 }
 
 static uint8_t rd_byte() {
-    auto c = get_byte();
-    uint8_t decoded_byte = c ^xor_byte;
-    xor_byte = c;
-
-    DEBUG(fprintf(logfile, "BYTE:  %02X = %d\n", (int) c, decoded_byte));
-
+    uint8_t decoded_byte = get_byte();
+    DEBUG(fprintf(logfile, "BYTE:  %d\n", decoded_byte));
     return decoded_byte;
 }
 
 static uint16_t rd_short() {
-    auto c = get_byte();
-    uint16_t decoded_int = c ^xor_byte;
-
-    xor_byte = get_byte();
-    decoded_int |= (uint16_t) (c ^ xor_byte) << 8;
-
-    DEBUG(fprintf(logfile, "SHORT: %02X %02X = %d\n", (int) c, (int) xor_byte, decoded_int));
-
+    uint16_t decoded_int = get_byte();
+    decoded_int |= (uint16_t) get_byte() << 8;
+    DEBUG(fprintf(logfile, "SHORT: %d\n", decoded_int));
     return decoded_int;
 }
 
 static uint32_t rd_long() {
-    auto c = get_byte();
-    uint32_t decoded_long = c ^xor_byte;
-
-    xor_byte = get_byte();
-    decoded_long |= (uint32_t) (c ^ xor_byte) << 8;
-    DEBUG(fprintf(logfile, "LONG:  %02X %02X ", (int) c, (int) xor_byte));
-
-    c = get_byte();
-    decoded_long |= (uint32_t) (c ^ xor_byte) << 16;
-
-    xor_byte = get_byte();
-    decoded_long |= (uint32_t) (c ^ xor_byte) << 24;
-    DEBUG(fprintf(logfile, "%02X %02X = %ld\n", (int) c, (int) xor_byte, decoded_long));
-
+    uint32_t decoded_long = get_byte();
+    decoded_long |= (uint32_t) get_byte() << 8;
+    decoded_long |= (uint32_t) get_byte() << 16;
+    decoded_long |= (uint32_t) get_byte() << 24;
+    DEBUG(fprintf(logfile, "LONG:  %ld\n", decoded_long));
     return decoded_long;
 }
 
 static void rd_bytes(uint8_t *value, int count) {
     DEBUG(fprintf(logfile, "%d BYTES:", count));
-    uint8_t *ptr = value;
     for (int i = 0; i < count; i++) {
-        auto c = get_byte();
-        *ptr++ = c ^ xor_byte;
-        xor_byte = c;
-        DEBUG(fprintf(logfile, "  %02X = %d", (int) c, (int) ptr[-1]));
+        value[i] = get_byte();
+        DEBUG(fprintf(logfile, "  %d", (int) value[i]));
     }
     DEBUG(fprintf(logfile, "\n"));
 }
 
 static void rd_string(char *str) {
     DEBUG(char *s = str);
-    DEBUG(fprintf(logfile, "STRING: "));
     do {
-        auto c = get_byte();
-        *str = c ^ xor_byte;
-        xor_byte = c;
-        DEBUG(fprintf(logfile, "%02X ", (int) c));
+        *str = (char) get_byte();
     } while (*str++ != '\0');
-    DEBUG(fprintf(logfile, "= \"%s\"\n", s));
+    DEBUG(fprintf(logfile, "STRING: \"%s\"\n", s));
 }
 
 static void rd_shorts(uint16_t *value, int count) {
     DEBUG(fprintf(logfile, "%d SHORTS:", count));
-    uint16_t *sptr = value;
-
     for (int i = 0; i < count; i++) {
-        auto c = get_byte();
-        uint16_t s = c ^xor_byte;
-        xor_byte = get_byte();
-        s |= (uint16_t) (c ^ xor_byte) << 8;
-        *sptr++ = s;
-        DEBUG(fprintf(logfile, "  %02X %02X = %d", (int) c, (int) xor_byte, (int) s));
+        value[i] = rd_short();
     }
     DEBUG(fprintf(logfile, "\n"));
 }
@@ -1157,14 +2264,14 @@ static void rd_item(Inventory_t &item) {
     item.identification = rd_byte();
 }
 
-static void rd_monster(Monster_t &monster) {
+static void rd_monster(Monster_t &monster, bool wide_coordinates) {
     DEBUG(fprintf(logfile, "MONSTER:\n"));
     monster.hp = rd_short();
     monster.sleep_count = rd_short();
     monster.speed = rd_short();
     monster.creature_id = rd_short();
-    monster.y = rd_byte();
-    monster.x = rd_byte();
+    monster.y = wide_coordinates ? rd_short() : rd_byte();
+    monster.x = wide_coordinates ? rd_short() : rd_byte();
     monster.distance_from_player = rd_byte();
     monster.lit = rd_bool();
     monster.stunned_amount = rd_byte();
@@ -1173,6 +2280,9 @@ static void rd_monster(Monster_t &monster) {
 
 // functions called from death.c to implement the score file
 
+// Size of a score in the score file, with its encryption byte.
+constexpr size_t HIGH_SCORE_RECORD_SIZE = 1 + 4 + 4 + 2 + 2 + 2 + 6 + PLAYER_NAME_SIZE + 25;
+
 // set the local fileptr to the score file fileptr
 void setFileptr(FILE *file) {
     fileptr = file;
@@ -1182,8 +2292,10 @@ void saveHighScore(HighScore_t const &score) {
     DEBUG(logfile = fopen("IO_LOG", "a"));
     DEBUG(fprintf(logfile, "Saving score:\n"));
 
+    save_buffer.clear();
+
     // Save the encryption byte for robustness.
-    wr_byte(xor_byte);
+    wr_byte(0);
 
     wr_long((uint32_t) score.points);
     wr_long((uint32_t) score.birth_date);
@@ -1199,14 +2311,27 @@ void saveHighScore(HighScore_t const &score) {
     wr_bytes((uint8_t *) score.name, PLAYER_NAME_SIZE);
     wr_bytes((uint8_t *) score.died_from, 25);
     DEBUG(fclose(logfile));
+
+    xorChainEncode(save_buffer.data(), save_buffer.size());
+    (void) fwrite(save_buffer.data(), 1, save_buffer.size(), fileptr);
 }
 
 void readHighScore(HighScore_t &score) {
     DEBUG(logfile = fopen("IO_LOG", "a"));
     DEBUG(fprintf(logfile, "Reading score:\n"));
 
+    // Each score is read in one go, which sets the end of file flag,
+    // as before, when there are no more scores.
+    save_buffer.resize(HIGH_SCORE_RECORD_SIZE);
+    save_buffer.resize(fread(save_buffer.data(), 1, save_buffer.size(), fileptr));
+    xorChainDecode(save_buffer.data(), save_buffer.size());
+
+    read_bytes = save_buffer.data();
+    read_size = save_buffer.size();
+    read_pos = 0;
+
     // Read the encryption byte.
-    xor_byte = get_byte();
+    (void) get_byte();
 
     score.points = rd_long();
     score.birth_date = rd_long();
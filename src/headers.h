@@ -23,8 +23,10 @@
 
 #elif __APPLE__ ||  __linux__
 
+    #include <dirent.h>
     #include <pwd.h>
     #include <unistd.h>
+    #include <sys/mman.h>
     #include <sys/param.h>
 
 #else
@@ -44,6 +46,7 @@
 #include <iostream>
 #include <limits>
 #include <string>
+#include <vector>
 
 #include <fcntl.h>
 #include <sys/stat.h>
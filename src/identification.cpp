@@ -233,46 +233,48 @@ void identifyGameObject() {
 void magicInitializeItemNames() {
     int id;
 
-    seedSet(game.magic_seed);
+    // The names are shuffled the same for the whole game, from its own stream
+    Rng_t rng;
+    rngSetSeed(rng, game.magic_seed);
 
     // The first 3 entries for colors are fixed, (slime & apple juice, water)
     for (int i = 3; i < MAX_COLORS; i++) {
-        id = randomNumber(MAX_COLORS - 3) + 2;
+        id = rngRandomNumber(rng, MAX_COLORS - 3) + 2;
         const char *color = colors[i];
         colors[i] = colors[id];
         colors[id] = color;
     }
 
     for (auto &w : woods) {
-        id = randomNumber(MAX_WOODS) - 1;
+        id = rngRandomNumber(rng, MAX_WOODS) - 1;
         const char *wood = w;
         w = woods[id];
         woods[id] = wood;
     }
 
     for (auto &m : metals) {
-        id = randomNumber(MAX_METALS) - 1;
+        id = rngRandomNumber(rng, MAX_METALS) - 1;
         const char *metal = m;
         m = metals[id];
         metals[id] = metal;
     }
 
     for (auto &r : rocks) {
-        id = randomNumber(MAX_ROCKS) - 1;
+        id = rngRandomNumber(rng, MAX_ROCKS) - 1;
         const char *rock = r;
         r = rocks[id];
         rocks[id] = rock;
     }
 
     for (auto &a : amulets) {
-        id = randomNumber(MAX_AMULETS) - 1;
+        id = rngRandomNumber(rng, MAX_AMULETS) - 1;
         const char *amulet = a;
         a = amulets[id];
         amulets[id] = amulet;
     }
 
     for (auto &m : mushrooms) {
-        id = randomNumber(MAX_MUSHROOMS) - 1;
+        id = rngRandomNumber(rng, MAX_MUSHROOMS) - 1;
         const char *mushroom = m;
         m = mushrooms[id];
         mushrooms[id] = mushroom;
@@ -283,11 +285,11 @@ void magicInitializeItemNames() {
 
     for (auto &item_title : magic_item_titles) {
         title[0] = '\0';
-        k = randomNumber(2) + 1;
+        k = rngRandomNumber(rng, 2) + 1;
 
         for (int i = 0; i < k; i++) {
-            for (int s = randomNumber(2); s > 0; s--) {
-                (void) strcat(title, syllables[randomNumber(MAX_SYLLABLES) - 1]);
+            for (int s = rngRandomNumber(rng, 2); s > 0; s--) {
+                (void) strcat(title, syllables[rngRandomNumber(rng, MAX_SYLLABLES) - 1]);
             }
             if (i < k - 1) {
                 (void) strcat(title, " ");
@@ -302,8 +304,6 @@ void magicInitializeItemNames() {
 
         (void) strcpy(item_title, title);
     }
-
-    seedResetToOldSeed();
 }
 
 int16_t objectPositionOffset(int category_id, int sub_category_id) {
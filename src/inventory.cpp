@@ -64,7 +64,7 @@ void inventoryDropItem(int item_id, bool drop_all) {
     Inventory_t &item = inventory[item_id];
     treasure_list[treasureID] = item;
 
-    dg.floor[py.row][py.col].treasure_id = (uint8_t) treasureID;
+    dungeonPlaceTreasure(Coord_t{py.row, py.col}, treasureID);
 
     if (item_id >= player_equipment::EQUIPMENT_WIELD) {
         playerTakeOff(item_id, -1);
@@ -12,6 +12,10 @@
 #include "version.h"
 
 static bool parseGameSeed(const char *argv, uint32_t &seed);
+static bool parseDungeonScale(const char *argv, int &scale);
+static bool parseAutosaveInterval(const char *argv, int &turns);
+static bool parseReplayOption(char option, const char *filename, uint32_t &seed, bool &new_game, bool &roguelike_keys);
+static const char *listSavesDirectory(int argc, char *argv[]);
 
 static const char *usage_instructions = R"(
 Usage:
@@ -24,6 +28,14 @@ Options:
     -r           Use classic roguelike keys: hjkl
     -d           Display high scores and exit
     -s NUMBER    Game Seed, as a decimal number (max: 2147483647)
+    -m SCALE     Dungeon size for new games, 1 (normal) to 4 times the height and width
+    -a TURNS     Autosave every TURNS game turns and on each new level (0: new levels only)
+    -b           Batch mode: run headless, reading keystrokes from stdin
+    -k FILE      Record the game seed and keystrokes to a replay FILE
+    -p FILE      Play back a replay FILE at maximum speed
+
+    --list-saves DIR
+                 List the characters of the save files in DIR and exit
 
     -v           Print version info and exit
     -h           Display this message
@@ -34,6 +46,19 @@ int main(int argc, char *argv[]) {
     uint32_t seed = 0;
     bool new_game = false;
     bool roguelike_keys = false;
+    bool display_scores = false;
+    int scale = 1;
+    int turns = 0;
+
+    // Listing the save files needs no score file, so is done before it is
+    // opened, but only once privileges are dropped, as DIR can be anywhere.
+    const char *list_saves_directory = listSavesDirectory(argc, argv);
+    if (list_saves_directory != nullptr) {
+        if (!checkFilePermissions()) {
+            return 1;
+        }
+        return listSaveFiles(list_saves_directory) ? 0 : 1;
+    }
 
     // call this routine to grab a file pointer to the high score file
     // and prepare things to relinquish setuid privileges
@@ -47,9 +72,8 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    if (!terminalInitialize()) {
-        return 1;
-    }
+    // Normal sized levels, unless changed by the options or a replay
+    dungeonSetScale(scale);
 
     // check for user interface option
     for (--argc, ++argv; argc > 0 && argv[0][0] == '-'; --argc, ++argv) {
@@ -67,8 +91,7 @@ int main(int argc, char *argv[]) {
                 roguelike_keys = true;
                 break;
             case 'd':
-                showScoresScreen();
-                exitProgram();
+                display_scores = true;
                 break;
             case 's':
                 // No NUMBER provided?
@@ -86,9 +109,67 @@ int main(int argc, char *argv[]) {
                     return -1;
                 }
 
+                break;
+            case 'm':
+                // No SCALE provided?
+                if (argv[1] == nullptr) {
+                    break;
+                }
+
+                // Move onto the SCALE value
+                --argc;
+                ++argv;
+
+                if (!parseDungeonScale(argv[0], scale)) {
+                    terminalRestore();
+                    printf("Dungeon scale must be a number between 1 and %d\n", DUNGEON_SCALE_MAX);
+                    return -1;
+                }
+
+                dungeonSetScale(scale);
+
+                break;
+            case 'a':
+                // No TURNS provided?
+                if (argv[1] == nullptr) {
+                    break;
+                }
+
+                // Move onto the TURNS value
+                --argc;
+                ++argv;
+
+                if (!parseAutosaveInterval(argv[0], turns)) {
+                    terminalRestore();
+                    printf("Autosave turns must be a number between 0 and %d\n", MAX_LONG);
+                    return -1;
+                }
+
+                autosaveSetInterval(turns);
+
                 break;
             case 'w':
                 game.to_be_wizard = true;
+                break;
+            case 'b':
+                terminalSetHeadless();
+                break;
+            case 'k':
+            case 'p':
+                // No FILE provided?
+                if (argv[1] == nullptr) {
+                    break;
+                }
+
+                if (!parseReplayOption(argv[0][1], argv[1], seed, new_game, roguelike_keys)) {
+                    printf("Unable to open the replay file: %s\n", argv[1]);
+                    return -1;
+                }
+
+                // Move past the FILE value
+                --argc;
+                ++argv;
+
                 break;
             default:
                 terminalRestore();
@@ -100,6 +181,24 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    // A restored game plays out from whatever the save file holds at the
+    // time, so only new games can be replayed exactly.
+    if ((replayIsRecording() || replayIsPlaying()) && !new_game) {
+        printf("Only new games, started with -n, can be recorded or played back\n");
+        return -1;
+    }
+
+    // The terminal is set up after the options are read,
+    // as batch mode replaces it with a headless one.
+    if (!terminalInitialize()) {
+        return 1;
+    }
+
+    if (display_scores) {
+        showScoresScreen();
+        exitProgram();
+    }
+
     // Auto-restart of saved file
     if (argv[0] != CNIL) {
         // (void) strcpy(config::files::save_game, argv[0]);
@@ -125,3 +224,59 @@ static bool parseGameSeed(const char *argv, uint32_t &seed) {
 
     return true;
 }
+
+static bool parseDungeonScale(const char *argv, int &scale) {
+    int value;
+
+    if (!stringToNumber(argv, value)) {
+        return false;
+    }
+    if (value < 1 || value > DUNGEON_SCALE_MAX) {
+        return false;
+    }
+
+    scale = value;
+
+    return true;
+}
+
+static bool parseAutosaveInterval(const char *argv, int &turns) {
+    int value;
+
+    if (!stringToNumber(argv, value)) {
+        return false;
+    }
+    if (value < 0 || value > MAX_LONG) {
+        return false;
+    }
+
+    turns = value;
+
+    return true;
+}
+
+// A playback also sets the options the recorded game was started with.
+static bool parseReplayOption(char option, const char *filename, uint32_t &seed, bool &new_game, bool &roguelike_keys) {
+    if (option == 'k') {
+        return replayStartRecording(filename);
+    }
+
+    return replayStartPlayback(filename, seed, new_game, roguelike_keys);
+}
+
+// The DIR of a --list-saves among the options, skipping over the values of
+// the other options, or null when there is none.
+static const char *listSavesDirectory(int argc, char *argv[]) {
+    for (int i = 1; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "--list-saves") == 0) {
+            return argv[i + 1];
+        }
+
+        // -s NUMBER, -m SCALE, -a TURNS, -k FILE and -p FILE
+        if (argv[i][1] != '\0' && strchr("smakp", argv[i][1]) != nullptr) {
+            i++;
+        }
+    }
+
+    return nullptr;
+}
@@ -19,10 +19,9 @@ static bool executeAttackOnPlayer(uint8_t creature_level, int16_t &monster_hp, i
 static bool monsterIsVisible(Monster_t const &monster) {
     bool visible = false;
 
-    Tile_t const &tile = dg.floor[monster.y][monster.x];
     Creature_t const &creature = creatures_list[monster.creature_id];
 
-    if (tile.permanent_light || tile.temporary_light || ((py.running_tracker != 0) && monster.distance_from_player < 2 && py.carrying_light)) {
+    if (dg.floor.permanent_light.test(monster.y, monster.x) || dg.floor.temporary_light.test(monster.y, monster.x) || ((py.running_tracker != 0) && monster.distance_from_player < 2 && py.carrying_light)) {
         // Normal sight.
         if ((creature.movement & config::monsters::move::CM_INVISIBLE) == 0) {
             visible = true;
@@ -255,6 +254,61 @@ static void monsterGetMoveDirection(int monster_id, int *directions) {
     }
 }
 
+// Is the tile in the direction one step closer to the player on the distance map?
+static bool monsterStepsCloser(Monster_t const &monster, int direction, int distance) {
+    int y = monster.y;
+    int x = monster.x;
+
+    if (direction == 5 || !playerMovePosition(direction, y, x)) {
+        return false;
+    }
+
+    int next_distance = dungeonFlowDistance(Coord_t{y, x});
+
+    return next_distance != FLOW_UNREACHED && next_distance < distance;
+}
+
+// Walls can be in the way of the directions picked by monsterGetMoveDirection(),
+// so when the first of them does not step closer along the player distance
+// map, a direction that does is tried first instead.
+static void monsterFollowFlow(int monster_id, int *directions) {
+    Monster_t const &monster = monsters[monster_id];
+
+    if ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_PHASE) != 0u) {
+        return;
+    }
+
+    int distance = dungeonFlowDistance(Coord_t{monster.y, monster.x});
+    if (distance == FLOW_UNREACHED || monsterStepsCloser(monster, directions[0], distance)) {
+        return;
+    }
+
+    // Prefer the other usual choices, before any of the remaining directions.
+    int best_direction = 0;
+    int best_index = 4; // the last choice, which makes way for a new direction
+    for (int i = 1; i < 5 && best_direction == 0; i++) {
+        if (monsterStepsCloser(monster, directions[i], distance)) {
+            best_direction = directions[i];
+            best_index = i;
+        }
+    }
+    for (int direction = 1; direction <= 9 && best_direction == 0; direction++) {
+        if (monsterStepsCloser(monster, direction, distance)) {
+            best_direction = direction;
+        }
+    }
+
+    if (best_direction == 0) {
+        return;
+    }
+
+    // Move it to the front, keeping the order of the others.
+    for (int i = best_index; i > 0; i--) {
+        directions[i] = directions[i - 1];
+    }
+    directions[0] = best_direction;
+}
+
 static void monsterPrintAttackDescription(char *msg, int attack_id) {
     switch (attack_id) {
         case 1:
@@ -517,7 +571,7 @@ static void monsterOpenDoor(Tile_t &tile, int16_t monster_hp, uint32_t move_bits
             if (door_is_stuck) {
                 item.misc_use = (int16_t) (1 - randomNumber(2));
             }
-            tile.feature_id = TILE_CORR_FLOOR;
+            dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
             dungeonLiteSpot(Coord_t{y, x});
             rcmove |= config::monsters::move::CM_OPEN_DOOR;
             do_move = false;
@@ -532,7 +586,7 @@ static void monsterOpenDoor(Tile_t &tile, int16_t monster_hp, uint32_t move_bits
 
             // 50% chance of breaking door
             item.misc_use = (int16_t) (1 - randomNumber(2));
-            tile.feature_id = TILE_CORR_FLOOR;
+            dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
             dungeonLiteSpot(Coord_t{y, x});
             printMessage("You hear a door burst open!");
             playerDisturb(1, 0);
@@ -558,7 +612,7 @@ static void glyphOfWardingProtection(uint16_t creature_id, uint32_t move_bits, b
     }
 }
 
-static void monsterMovesOnPlayer(Monster_t const &monster, uint8_t creature_id, int monster_id, uint32_t move_bits, bool &do_move, bool &do_turn, uint32_t &rcmove, int y, int x) {
+static void monsterMovesOnPlayer(Monster_t const &monster, uint16_t creature_id, int monster_id, uint32_t move_bits, bool &do_move, bool &do_turn, uint32_t &rcmove, int y, int x) {
     if (creature_id == 1) {
         // if the monster is not lit, must call monsterUpdateVisibility, it
         // may be faster than character, and hence could have
@@ -596,7 +650,7 @@ static void monsterMovesOnPlayer(Monster_t const &monster, uint8_t creature_id,
 static void monsterAllowedToMove(Monster_t &monster, uint32_t move_bits, bool &do_turn, uint32_t &rcmove, int y, int x) {
     // Pick up or eat an object
     if ((move_bits & config::monsters::move::CM_PICKS_UP) != 0u) {
-        uint8_t treasure_id = dg.floor[y][x].treasure_id;
+        uint16_t treasure_id = dg.floor[y][x].treasure_id;
 
         if (treasure_id != 0 && treasure_list[treasure_id].category_id <= TV_MAX_OBJECT) {
             rcmove |= config::monsters::move::CM_PICKS_UP;
@@ -612,9 +666,9 @@ static void monsterAllowedToMove(Monster_t &monster, uint32_t move_bits, bool &d
         dungeonLiteSpot(Coord_t{monster.y, monster.x});
     }
 
-    monster.y = (uint8_t) y;
-    monster.x = (uint8_t) x;
-    monster.distance_from_player = (uint8_t) coordDistanceBetween(Coord_t{py.row, py.col}, Coord_t{y, x});
+    monster.y = (uint16_t) y;
+    monster.x = (uint16_t) x;
+    monsterUpdateDistance(monster);
 
     do_turn = true;
 }
@@ -1136,6 +1190,7 @@ static void monsterMoveNormally(int monster_id, uint32_t &rcmove) {
         directions[4] = randomNumber(9);
     } else {
         monsterGetMoveDirection(monster_id, directions);
+        monsterFollowFlow(monster_id, directions);
     }
 
     rcmove |= config::monsters::move::CM_MOVE_NORMAL;
@@ -1244,6 +1299,34 @@ static void memoryUpdateRecall(Monster_t const &monster, bool wake, bool ignore,
     memory.movement |= rcmove;
 }
 
+// Only a monster within sight and on the panel can become visible, and only
+// a lit one can be turned off, so the others are skipped here without going
+// near their creature or tile records.
+static bool monsterVisibilityCanChange(Monster_t const &monster) {
+    if (monster.lit) {
+        return true;
+    }
+
+    return monster.distance_from_player <= config::monsters::MON_MAX_SIGHT && coordInsidePanel(Coord_t{monster.y, monster.x});
+}
+
+// Monsters out of sight and beyond their area of effect do nothing at all.
+static bool monsterIsActive(Monster_t const &monster) {
+    if (monster.lit) {
+        return true;
+    }
+
+    Creature_t const &creature = creatures_list[monster.creature_id];
+
+    if (monster.distance_from_player <= creature.area_affect_radius) {
+        return true;
+    }
+
+    // Monsters trapped in rock must be given a turn also,
+    // so that they will die/dig out immediately.
+    return (creature.movement & config::monsters::move::CM_PHASE) == 0u && dg.floor[monster.y][monster.x].feature_id >= MIN_CAVE_WALL;
+}
+
 static void monsterAttackingUpdate(Monster_t &monster, int monster_id, int moves) {
     for (int i = moves; i > 0; i--) {
         bool wake = false;
@@ -1251,49 +1334,59 @@ static void monsterAttackingUpdate(Monster_t &monster, int monster_id, int moves
 
         uint32_t rcmove = 0;
 
-        // Monsters trapped in rock must be given a turn also,
-        // so that they will die/dig out immediately.
-        if (monster.lit || monster.distance_from_player <= creatures_list[monster.creature_id].area_affect_radius || (((creatures_list[monster.creature_id].movement & config::monsters::move::CM_PHASE) == 0u) && dg.floor[monster.y][monster.x].feature_id >= MIN_CAVE_WALL)) {
-            if (monster.sleep_count > 0) {
-                if (py.flags.aggravate) {
-                    monster.sleep_count = 0;
-                } else if ((py.flags.rest == 0 && py.flags.paralysis < 1) || (randomNumber(50) == 1)) {
-                    int notice = randomNumber(1024);
-
-                    if (notice * notice * notice <= (1L << (29 - py.misc.stealth_factor))) {
-                        monster.sleep_count -= (100 / monster.distance_from_player);
-                        if (monster.sleep_count > 0) {
-                            ignore = true;
-                        } else {
-                            wake = true;
+        if (!monsterIsActive(monster)) {
+            if (monsterVisibilityCanChange(monster)) {
+                monsterUpdateVisibility(monster_id);
+            }
 
-                            // force it to be exactly zero
-                            monster.sleep_count = 0;
-                        }
-                    }
-                }
+            // Nothing has moved, so each of the remaining moves would
+            // end up the same way, unless the monster has just been seen.
+            if (!monster.lit) {
+                return;
             }
 
-            if (monster.stunned_amount != 0) {
-                // NOTE: Balrog = 100*100 = 10000, it always recovers instantly
-                if (randomNumber(5000) < creatures_list[monster.creature_id].level * creatures_list[monster.creature_id].level) {
-                    monster.stunned_amount = 0;
-                } else {
-                    monster.stunned_amount--;
-                }
+            continue;
+        }
 
-                if (monster.stunned_amount == 0) {
-                    if (monster.lit) {
-                        vtype_t msg = {'\0'};
-                        (void) sprintf(msg, "The %s ", creatures_list[monster.creature_id].name);
-                        printMessage(strcat(msg, "recovers and glares at you."));
+        if (monster.sleep_count > 0) {
+            if (py.flags.aggravate) {
+                monster.sleep_count = 0;
+            } else if ((py.flags.rest == 0 && py.flags.paralysis < 1) || (randomNumber(50) == 1)) {
+                int notice = randomNumber(1024);
+
+                if (notice * notice * notice <= (1L << (29 - py.misc.stealth_factor))) {
+                    monster.sleep_count -= (100 / monster.distance_from_player);
+                    if (monster.sleep_count > 0) {
+                        ignore = true;
+                    } else {
+                        wake = true;
+
+                        // force it to be exactly zero
+                        monster.sleep_count = 0;
                     }
                 }
             }
-            if ((monster.sleep_count == 0) && (monster.stunned_amount == 0)) {
-                monsterMove(monster_id, rcmove);
+        }
+
+        if (monster.stunned_amount != 0) {
+            // NOTE: Balrog = 100*100 = 10000, it always recovers instantly
+            if (randomNumber(5000) < creatures_list[monster.creature_id].level * creatures_list[monster.creature_id].level) {
+                monster.stunned_amount = 0;
+            } else {
+                monster.stunned_amount--;
+            }
+
+            if (monster.stunned_amount == 0) {
+                if (monster.lit) {
+                    vtype_t msg = {'\0'};
+                    (void) sprintf(msg, "The %s ", creatures_list[monster.creature_id].name);
+                    printMessage(strcat(msg, "recovers and glares at you."));
+                }
             }
         }
+        if ((monster.sleep_count == 0) && (monster.stunned_amount == 0)) {
+            monsterMove(monster_id, rcmove);
+        }
 
         monsterUpdateVisibility(monster_id);
         memoryUpdateRecall(monster, wake, ignore, rcmove);
@@ -1302,6 +1395,8 @@ static void monsterAttackingUpdate(Monster_t &monster, int monster_id, int moves
 
 // Creatures movement and attacking are done from here -RAK-
 void updateMonsters(bool attack) {
+    dungeonFlowUpdate();
+
     // Process the monsters
     for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID && !game.character_is_dead; id--) {
         Monster_t &monster = monsters[id];
@@ -1314,18 +1409,18 @@ void updateMonsters(bool attack) {
             continue;
         }
 
-        monster.distance_from_player = (uint8_t) coordDistanceBetween(Coord_t{py.row, py.col}, Coord_t{monster.y, monster.x});
+        monsterUpdateDistance(monster);
 
         // Attack is argument passed to CREATURE
         if (attack) {
             int moves = monsterMovementRate(monster.speed);
 
-            if (moves <= 0) {
-                monsterUpdateVisibility(id);
-            } else {
+            if (moves > 0) {
                 monsterAttackingUpdate(monster, id, moves);
+            } else if (monsterVisibilityCanChange(monster)) {
+                monsterUpdateVisibility(id);
             }
-        } else {
+        } else if (monsterVisibilityCanChange(monster)) {
             monsterUpdateVisibility(id);
         }
 
@@ -1498,9 +1593,9 @@ std::string monsterNameDescription(const std::string &real_name, bool is_lit) {
 bool monsterSleep(int y, int x) {
     bool asleep = false;
 
-    for (int row = y - 1; row <= y + 1 && row < MAX_HEIGHT; row++) {
-        for (int col = x - 1; col <= x + 1 && col < MAX_WIDTH; col++) {
-            uint8_t monster_id = dg.floor[row][col].creature_id;
+    for (int row = y - 1; row <= y + 1 && row < dg.height; row++) {
+        for (int col = x - 1; col <= x + 1 && col < dg.width; col++) {
+            uint16_t monster_id = dg.floor[row][col].creature_id;
 
             if (monster_id <= 1) {
                 continue;
@@ -15,16 +15,19 @@ typedef struct {
     int16_t speed;        // Movement speed
     uint16_t creature_id; // Pointer into creature
 
-    // Note: fy, fx, and cdis constrain dungeon size to less than 256 by 256
-    uint8_t y;  // Y Pointer into map
-    uint8_t x;  // X Pointer into map
-    uint8_t distance_from_player; // Current distance from player
+    uint16_t y; // Y Pointer into map
+    uint16_t x; // X Pointer into map
+    uint8_t distance_from_player; // Current distance from player, up to MAX_UCHAR
 
     bool lit;
     uint8_t stunned_amount;
     uint8_t confused_amount;
 } Monster_t;
 
+// updateMonsters() reads every one of these fields each game turn, so they are
+// kept small enough for the whole monsters[] table to sit in a few KB of cache.
+static_assert(sizeof(Monster_t) <= 16, "Monster_t should stay within 16 bytes");
+
 // Creature_t is a base data object.
 // Holds the base game data for any given creature in the game such
 // as: Kobold, Orc, Giant Red Ant, Quasit, Young Black Dragon, etc.
@@ -56,11 +59,11 @@ typedef struct {
 constexpr uint16_t MON_MAX_CREATURES = 279; // Number of creatures defined for univ
 constexpr uint8_t MON_ATTACK_TYPES = 215;   // Number of monster attack types.
 
-// With MON_TOTAL_ALLOCATIONS set to 101, it is possible to get compacting
+// With MON_TOTAL_ALLOCATIONS set to 125, it was possible to get compacting
 // monsters messages while breeding/cloning monsters.
-constexpr uint8_t MON_TOTAL_ALLOCATIONS = 125; // Max that can be allocated
-constexpr uint8_t MON_MAX_LEVELS = 40;         // Maximum level of creatures
-constexpr uint8_t MON_MAX_ATTACKS = 4;         // Max num attacks (used in mons memory) -CJS-
+constexpr uint16_t MON_TOTAL_ALLOCATIONS = 1000; // Max that can be allocated
+constexpr uint8_t MON_MAX_LEVELS = 40;           // Maximum level of creatures
+constexpr uint8_t MON_MAX_ATTACKS = 4;           // Max num attacks (used in mons memory) -CJS-
 
 extern int hack_monptr;
 extern Creature_t creatures_list[MON_MAX_CREATURES];
@@ -79,6 +82,7 @@ int monsterTakeHit(int monster_id, int damage);
 void printMonsterActionText(const std::string &name, const std::string &action);
 std::string monsterNameDescription(const std::string &real_name, bool is_lit);
 bool monsterSleep(int y, int x);
+void monsterUpdateDistance(Monster_t &monster);
 
 // monster management
 bool compactMonsters();
@@ -87,3 +91,11 @@ void monsterPlaceWinning();
 void monsterPlaceNewWithinDistance(int number, int distance_from_source, bool sleeping);
 bool monsterSummon(int &y, int &x, bool sleeping);
 bool monsterSummonUndead(int &y, int &x);
+
+// monster index
+void monsterIndexClear();
+void monsterIndexRebuild();
+void monsterIndexMove(int id, Coord_t const &from, Coord_t const &to);
+void monsterIndexDelete(int id, int last_id);
+int monstersWithinDistance(Coord_t const &coord, int distance, int16_t *ids);
+int monstersInsidePanel(int16_t *ids);
@@ -19,6 +19,145 @@ Monster_t blank_monster = {0, 0, 0, 0, 0, 0, 0, false, 0, 0};
 int16_t next_free_monster_id;    // ID for the next available monster ptr
 int16_t monster_multiply_total;  // Total number of reproduction's of creatures
 
+// Monsters are also kept in lists for each 8x8 block of the dungeon, so the
+// monsters near the player can be found without looking at every monster.
+// A monster ID of 0 is never used, so marks the end of a list.
+constexpr int MON_BUCKET_SHIFT = 3;
+constexpr int MON_BUCKET_ROWS = (DUNGEON_HEIGHT_MAX >> MON_BUCKET_SHIFT) + 1;
+constexpr int MON_BUCKET_COLS = (DUNGEON_WIDTH_MAX >> MON_BUCKET_SHIFT) + 1;
+
+static int16_t bucket_first_id[MON_BUCKET_ROWS][MON_BUCKET_COLS];
+static int16_t bucket_next_id[MON_TOTAL_ALLOCATIONS];
+static int16_t bucket_previous_id[MON_TOTAL_ALLOCATIONS];
+
+static int16_t &monsterBucket(Coord_t const &coord) {
+    return bucket_first_id[coord.y >> MON_BUCKET_SHIFT][coord.x >> MON_BUCKET_SHIFT];
+}
+
+static void monsterIndexInsert(int id, Coord_t const &coord) {
+    int16_t &first_id = monsterBucket(coord);
+
+    bucket_previous_id[id] = 0;
+    bucket_next_id[id] = first_id;
+    if (first_id != 0) {
+        bucket_previous_id[first_id] = (int16_t) id;
+    }
+    first_id = (int16_t) id;
+}
+
+static void monsterIndexRemove(int id, Coord_t const &coord) {
+    int16_t next_id = bucket_next_id[id];
+    int16_t previous_id = bucket_previous_id[id];
+
+    if (previous_id != 0) {
+        bucket_next_id[previous_id] = next_id;
+    } else {
+        monsterBucket(coord) = next_id;
+    }
+    if (next_id != 0) {
+        bucket_previous_id[next_id] = previous_id;
+    }
+}
+
+// Empty the index, for when all the monsters are removed.
+void monsterIndexClear() {
+    for (auto &row : bucket_first_id) {
+        for (auto &first_id : row) {
+            first_id = 0;
+        }
+    }
+}
+
+// Rebuild the index from the monsters list, e.g. after loading a game.
+void monsterIndexRebuild() {
+    monsterIndexClear();
+
+    for (int id = config::monsters::MON_MIN_INDEX_ID; id < next_free_monster_id; id++) {
+        monsterIndexInsert(id, Coord_t{monsters[id].y, monsters[id].x});
+    }
+}
+
+// Called before a monster record is moved to another tile.
+void monsterIndexMove(int id, Coord_t const &from, Coord_t const &to) {
+    if ((from.y >> MON_BUCKET_SHIFT) == (to.y >> MON_BUCKET_SHIFT) && (from.x >> MON_BUCKET_SHIFT) == (to.x >> MON_BUCKET_SHIFT)) {
+        return;
+    }
+
+    monsterIndexRemove(id, from);
+    monsterIndexInsert(id, to);
+}
+
+// Called when the monster is deleted, and the last monster in the
+// list (`last_id`) is moved into its place.
+void monsterIndexDelete(int id, int last_id) {
+    monsterIndexRemove(id, Coord_t{monsters[id].y, monsters[id].x});
+
+    if (id != last_id) {
+        Coord_t coord = Coord_t{monsters[last_id].y, monsters[last_id].x};
+        monsterIndexRemove(last_id, coord);
+        monsterIndexInsert(id, coord);
+    }
+}
+
+// Find the monsters in an area, returning how many were found. The IDs are
+// put in `ids` from highest to lowest, the same order as when looping over
+// the monsters list, so the results don't change by using the index.
+static int monstersInArea(Coord_t top_left, Coord_t bottom_right, int16_t *ids) {
+    if (top_left.y < 0) {
+        top_left.y = 0;
+    }
+    if (top_left.x < 0) {
+        top_left.x = 0;
+    }
+    if (bottom_right.y > dg.height - 1) {
+        bottom_right.y = dg.height - 1;
+    }
+    if (bottom_right.x > dg.width - 1) {
+        bottom_right.x = dg.width - 1;
+    }
+
+    int count = 0;
+
+    for (int row = top_left.y >> MON_BUCKET_SHIFT; row <= bottom_right.y >> MON_BUCKET_SHIFT; row++) {
+        for (int col = top_left.x >> MON_BUCKET_SHIFT; col <= bottom_right.x >> MON_BUCKET_SHIFT; col++) {
+            for (int id = bucket_first_id[row][col]; id != 0; id = bucket_next_id[id]) {
+                Monster_t const &monster = monsters[id];
+
+                if (monster.y < top_left.y || monster.y > bottom_right.y || monster.x < top_left.x || monster.x > bottom_right.x) {
+                    continue;
+                }
+
+                int i = count++;
+                for (; i > 0 && ids[i - 1] < id; i--) {
+                    ids[i] = ids[i - 1];
+                }
+                ids[i] = (int16_t) id;
+            }
+        }
+    }
+
+    return count;
+}
+
+// Monsters no further than `distance` from the coord, see monstersInArea().
+int monstersWithinDistance(Coord_t const &coord, int distance, int16_t *ids) {
+    int count = monstersInArea(Coord_t{coord.y - distance, coord.x - distance}, Coord_t{coord.y + distance, coord.x + distance}, ids);
+
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        if (coordDistanceBetween(coord, Coord_t{monsters[ids[i]].y, monsters[ids[i]].x}) <= distance) {
+            ids[found++] = ids[i];
+        }
+    }
+
+    return found;
+}
+
+// Monsters on the current panel, see monstersInArea().
+int monstersInsidePanel(int16_t *ids) {
+    return monstersInArea(Coord_t{dg.panel.top, dg.panel.left}, Coord_t{dg.panel.bottom, dg.panel.right}, ids);
+}
+
 // Returns a pointer to next free space -RAK-
 // Returns -1 if could not allocate a monster.
 static int popm() {
@@ -30,6 +169,17 @@ static int popm() {
     return next_free_monster_id++;
 }
 
+// The distance is kept in a byte. On the larger dungeons, the monsters
+// further away than that are left at MAX_UCHAR, well out of sight.
+void monsterUpdateDistance(Monster_t &monster) {
+    int distance = coordDistanceBetween(Coord_t{py.row, py.col}, Coord_t{monster.y, monster.x});
+    if (distance > MAX_UCHAR) {
+        distance = MAX_UCHAR;
+    }
+
+    monster.distance_from_player = (uint8_t) distance;
+}
+
 // Places a monster at given location -RAK-
 bool monsterPlaceNew(int y, int x, int creature_id, bool sleeping) {
     int monster_id = popm();
@@ -41,8 +191,8 @@ bool monsterPlaceNew(int y, int x, int creature_id, bool sleeping) {
 
     Monster_t &monster = monsters[monster_id];
 
-    monster.y = (uint8_t) y;
-    monster.x = (uint8_t) x;
+    monster.y = (uint16_t) y;
+    monster.x = (uint16_t) x;
     monster.creature_id = (uint16_t) creature_id;
 
     if ((creatures_list[creature_id].defenses & config::monsters::defense::CD_MAX_HP) != 0) {
@@ -54,10 +204,11 @@ bool monsterPlaceNew(int y, int x, int creature_id, bool sleeping) {
     // the creatures_list[] speed value is 10 greater, so that it can be a uint8_t
     monster.speed = (int16_t) (creatures_list[creature_id].speed - 10 + py.flags.speed);
     monster.stunned_amount = 0;
-    monster.distance_from_player = (uint8_t) coordDistanceBetween(Coord_t{py.row, py.col}, Coord_t{y, x});
+    monsterUpdateDistance(monster);
     monster.lit = false;
 
-    dg.floor[y][x].creature_id = (uint8_t) monster_id;
+    dg.floor[y][x].creature_id = (uint16_t) monster_id;
+    monsterIndexInsert(monster_id, Coord_t{y, x});
 
     if (sleeping) {
         if (creatures_list[creature_id].sleep_counter == 0) {
@@ -101,8 +252,8 @@ void monsterPlaceWinning() {
 
     Monster_t &monster = monsters[monster_id];
 
-    monster.y = (uint8_t) y;
-    monster.x = (uint8_t) x;
+    monster.y = (uint16_t) y;
+    monster.x = (uint16_t) x;
     monster.creature_id = (uint16_t) creature_id;
 
     if ((creatures_list[creature_id].defenses & config::monsters::defense::CD_MAX_HP) != 0) {
@@ -114,9 +265,10 @@ void monsterPlaceWinning() {
     // the creatures_list speed value is 10 greater, so that it can be a uint8_t
     monster.speed = (int16_t) (creatures_list[creature_id].speed - 10 + py.flags.speed);
     monster.stunned_amount = 0;
-    monster.distance_from_player = (uint8_t) coordDistanceBetween(Coord_t{py.row, py.col}, Coord_t{y, x});
+    monsterUpdateDistance(monster);
 
-    dg.floor[y][x].creature_id = (uint8_t) monster_id;
+    dg.floor[y][x].creature_id = (uint16_t) monster_id;
+    monsterIndexInsert(monster_id, Coord_t{y, x});
 
     monster.sleep_count = 0;
 }
@@ -127,8 +127,9 @@ void playerTeleport(int new_distance) {
     dungeonMoveCreatureRecord(Coord_t{py.row, py.col}, Coord_t{new_y, new_x});
 
     for (int y = py.row - 1; y <= py.row + 1; y++) {
+        floorBitsResetRange(dg.floor.temporary_light, y, py.col - 1, py.col + 1);
+
         for (int x = py.col - 1; x <= py.col + 1; x++) {
-            dg.floor[y][x].temporary_light = false;
             dungeonLiteSpot(Coord_t{y, x});
         }
     }
@@ -146,7 +147,7 @@ void playerTeleport(int new_distance) {
 
 // Returns true if player has no light -RAK-
 bool playerNoLight() {
-    return !dg.floor[py.row][py.col].temporary_light && !dg.floor[py.row][py.col].permanent_light;
+    return !dg.floor.temporary_light.test(py.row, py.col) && !dg.floor.permanent_light.test(py.row, py.col);
 }
 
 // Something happens to disturb the player. -CJS-
@@ -1271,7 +1272,7 @@ static void openClosedDoor(int y, int x) {
 
     if (item.misc_use == 0) {
         inventoryItemCopyTo(config::dungeon::objects::OBJ_OPEN_DOOR, treasure_list[tile.treasure_id]);
-        tile.feature_id = TILE_CORR_FLOOR;
+        dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
         dungeonLiteSpot(Coord_t{y, x});
         game.command_count = 0;
     }
@@ -1386,7 +1387,7 @@ void playerCloseDoor() {
             if (tile.creature_id == 0) {
                 if (item.misc_use == 0) {
                     inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, item);
-                    tile.feature_id = TILE_BLOCKED_FLOOR;
+                    dungeonSetTileFeature(tile, TILE_BLOCKED_FLOOR);
                     dungeonLiteSpot(Coord_t{y, x});
                 } else {
                     printMessage("The door appears to be broken.");
@@ -1416,16 +1417,16 @@ bool playerTunnelWall(int y, int x, int digging_ability, int digging_chance) {
 
     Tile_t &tile = dg.floor[y][x];
 
-    if (tile.perma_lit_room) {
+    if (dg.floor.perma_lit_room.test(y, x)) {
         // Should become a room space, check to see whether
         // it should be TILE_LIGHT_FLOOR or TILE_DARK_FLOOR.
         bool found = false;
 
-        for (int yy = y - 1; yy <= y + 1 && yy < MAX_HEIGHT; yy++) {
-            for (int xx = x - 1; xx <= x + 1 && xx < MAX_WIDTH; xx++) {
+        for (int yy = y - 1; yy <= y + 1 && yy < dg.height; yy++) {
+            for (int xx = x - 1; xx <= x + 1 && xx < dg.width; xx++) {
                 if (dg.floor[yy][xx].feature_id <= MAX_CAVE_ROOM) {
-                    tile.feature_id = dg.floor[yy][xx].feature_id;
-                    tile.permanent_light = dg.floor[yy][xx].permanent_light;
+                    dungeonSetTileFeature(tile, dg.floor[yy][xx].feature_id);
+                    dg.floor.permanent_light.assign(y, x, dg.floor.permanent_light.test(yy, xx));
                     found = true;
                     break;
                 }
@@ -1433,18 +1434,18 @@ bool playerTunnelWall(int y, int x, int digging_ability, int digging_chance) {
         }
 
         if (!found) {
-            tile.feature_id = TILE_CORR_FLOOR;
-            tile.permanent_light = false;
+            dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
+            dg.floor.permanent_light.reset(y, x);
         }
     } else {
         // should become a corridor space
-        tile.feature_id = TILE_CORR_FLOOR;
-        tile.permanent_light = false;
+        dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
+        dg.floor.permanent_light.reset(y, x);
     }
 
-    tile.field_mark = false;
+    dg.floor.field_mark.reset(y, x);
 
-    if (coordInsidePanel(Coord_t{y, x}) && (tile.temporary_light || tile.permanent_light) && tile.treasure_id != 0) {
+    if (coordInsidePanel(Coord_t{y, x}) && (dg.floor.temporary_light.test(y, x) || dg.floor.permanent_light.test(y, x)) && tile.treasure_id != 0) {
         printMessage("You have found something!");
     }
 
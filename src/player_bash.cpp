@@ -189,7 +189,7 @@ static void playerBashClosedDoor(int y, int x, int dir, Tile_t &tile, Inventory_
         // 50% chance of breaking door
         item.misc_use = (int16_t) (1 - randomNumber(2));
 
-        tile.feature_id = TILE_CORR_FLOOR;
+        dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
 
         if (py.flags.confused == 0) {
             playerMove(dir, false);
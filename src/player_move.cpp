@@ -482,15 +482,15 @@ void playerMove(int direction, bool do_pickup) {
             if (tile.feature_id == TILE_LIGHT_FLOOR) {
                 // A room of light should be lit.
 
-                if (!tile.permanent_light && (py.flags.blind == 0)) {
+                if (!dg.floor.permanent_light.test(y, x) && (py.flags.blind == 0)) {
                     dungeonLightRoom(Coord_t{py.row, py.col});
                 }
-            } else if (tile.perma_lit_room && py.flags.blind < 1) {
+            } else if (dg.floor.perma_lit_room.test(y, x) && py.flags.blind < 1) {
                 // In doorway of light-room?
 
                 for (int row = (py.row - 1); row <= (py.row + 1); row++) {
                     for (int col = (py.col - 1); col <= (py.col + 1); col++) {
-                        if (dg.floor[row][col].feature_id == TILE_LIGHT_FLOOR && !dg.floor[row][col].permanent_light) {
+                        if (dg.floor[row][col].feature_id == TILE_LIGHT_FLOOR && !dg.floor.permanent_light.test(row, col)) {
                             dungeonLightRoom(Coord_t{row, col});
                         }
                     }
@@ -514,7 +514,7 @@ void playerMove(int direction, bool do_pickup) {
                     py.col = (int16_t) old_col;
 
                     // check to see if we have stepped back onto another trap, if so, set it off
-                    uint8_t id = dg.floor[py.row][py.col].treasure_id;
+                    uint16_t id = dg.floor[py.row][py.col].treasure_id;
                     if (id != 0) {
                         int val = treasure_list[id].category_id;
                         if (val == TV_INVIS_TRAP || val == TV_VIS_TRAP || val == TV_STORE_DOOR) {
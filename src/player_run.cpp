@@ -251,7 +251,7 @@ static bool areaAffectStopLookingAtSquares(int i, int dir, int new_dir, int y, i
     // Default: Square unseen. Treat as open.
     bool invisible = true;
 
-    if (py.carrying_light || tile.temporary_light || tile.permanent_light || tile.field_mark) {
+    if (py.carrying_light || caveTileVisible(Coord_t{y, x})) {
         if (tile.treasure_id != 0) {
             int tileID = treasure_list[tile.treasure_id].category_id;
 
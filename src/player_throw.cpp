@@ -140,7 +140,7 @@ static void inventoryDropOrThrowItem(int y, int x, Inventory_t *item) {
 
     if (flag) {
         int cur_pos = popt();
-        dg.floor[pos_y][pos_x].treasure_id = (uint8_t) cur_pos;
+        dungeonPlaceTreasure(Coord_t{pos_y, pos_x}, cur_pos);
         treasure_list[cur_pos] = *item;
         dungeonLiteSpot(Coord_t{pos_y, pos_x});
     } else {
@@ -266,7 +266,7 @@ void playerThrowItem() {
             } else {
                 // do not test tile.field_mark here
 
-                if (coordInsidePanel(Coord_t{y, x}) && py.flags.blind < 1 && (tile.temporary_light || tile.permanent_light)) {
+                if (coordInsidePanel(Coord_t{y, x}) && py.flags.blind < 1 && (dg.floor.temporary_light.test(y, x) || dg.floor.permanent_light.test(y, x))) {
                     panelPutTile(tile_char, Coord_t{y, x});
                     putQIO(); // show object moving
                 }
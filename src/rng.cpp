@@ -62,33 +62,136 @@
 
 constexpr int32_t RNG_M = MAX_LONG; // m = 2^31 - 1
 constexpr int32_t RNG_A = 16807L;
-constexpr int32_t RNG_Q = RNG_M / RNG_A; // m div a 127773L
-constexpr int32_t RNG_R = RNG_M % RNG_A;   // m mod a 2836L
 
-// 32 bit seed
-static uint32_t rnd_seed;
+constexpr int RNG_FILL_LANES = 8;
 
-uint32_t getRandomSeed() {
-    return rnd_seed;
+// Streams are a quarter of the full period apart, so they never overlap.
+constexpr uint64_t RNG_STREAM_SPACING = (uint64_t) (RNG_M - 1) / 4;
+
+// The game's global random number stream
+static Rng_t rnd_state;
+
+// Returns (a * b) mod m, for a, b in 0, 1, ..., m - 1
+static uint32_t rngMultiplyModulo(uint32_t a, uint32_t b) {
+    uint64_t product = (uint64_t) a * b;
+
+    // As m = 2^31 - 1, then 2^31 mod m = 1, which lets the high bits
+    // be folded onto the low ones instead of doing a 64 bit divide.
+    auto result = (uint32_t) ((product & RNG_M) + (product >> 31));
+    result = (result & RNG_M) + (result >> 31);
+
+    if (result >= (uint32_t) RNG_M) {
+        result -= RNG_M;
+    }
+
+    return result;
 }
 
-void setRandomSeed(uint32_t seed) {
+void rngSetSeed(Rng_t &rng, uint32_t seed) {
     // set seed to value between 1 and m-1
-    rnd_seed = (uint32_t) ((seed % (RNG_M - 1)) + 1);
+    rng.seed = (uint32_t) ((seed % (RNG_M - 1)) + 1);
 }
 
 // returns a pseudo-random number from set 1, 2, ..., RNG_M - 1
-int32_t rnd() {
-    auto high = (int32_t) (rnd_seed / RNG_Q);
-    auto low = (int32_t) (rnd_seed % RNG_Q);
-    auto test = (int32_t) (RNG_A * low - RNG_R * high);
-
-    if (test > 0) {
-        rnd_seed = (uint32_t) test;
-    } else {
-        rnd_seed = (uint32_t) (test + RNG_M);
+//
+// This gives exactly the same sequence as Schrage's method, but
+// uses a single 64 bit multiply instead of a divide and modulo.
+int32_t rngNext(Rng_t &rng) {
+    rng.seed = rngMultiplyModulo(rng.seed, RNG_A);
+
+    return (int32_t) rng.seed;
+}
+
+// Generates a random integer x where 1<=X<=MAXVAL
+int rngRandomNumber(Rng_t &rng, int max) {
+    return (rngNext(rng) % max) + 1;
+}
+
+// Advance the stream by `steps` numbers in O(log n) time, as
+// z[n + steps] = (a^steps mod m) * z[n] mod m
+void rngJumpAhead(Rng_t &rng, uint64_t steps) {
+    uint32_t multiplier = 1;
+    uint32_t power = RNG_A;
+
+    for (; steps != 0; steps >>= 1) {
+        if ((steps & 1) != 0) {
+            multiplier = rngMultiplyModulo(multiplier, power);
+        }
+        power = rngMultiplyModulo(power, power);
+    }
+
+    rng.seed = rngMultiplyModulo(rng.seed, multiplier);
+}
+
+// Fill `values` with the next `count` numbers of the stream, the same as
+// calling rngNext() `count` times.
+//
+// As z[n + k] = a^k * z[n] mod m, the values are worked out in lanes of
+// RNG_FILL_LANES, each lane stepping a^RNG_FILL_LANES ahead of the last
+// block. The lanes don't depend on each other, so the loop vectorizes.
+void rngFill(Rng_t &rng, int32_t *values, int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    // a^1, a^2, ..., a^RNG_FILL_LANES
+    static uint32_t lane_multipliers[RNG_FILL_LANES] = {0};
+    if (lane_multipliers[0] == 0) {
+        uint32_t multiplier = 1;
+        for (auto &lane_multiplier : lane_multipliers) {
+            multiplier = rngMultiplyModulo(multiplier, RNG_A);
+            lane_multiplier = multiplier;
+        }
+    }
+
+    int lanes = count < RNG_FILL_LANES ? count : RNG_FILL_LANES;
+    for (int i = 0; i < lanes; i++) {
+        values[i] = (int32_t) rngMultiplyModulo(rng.seed, lane_multipliers[i]);
+    }
+
+    uint32_t block_multiplier = lane_multipliers[RNG_FILL_LANES - 1];
+    for (int i = RNG_FILL_LANES; i < count; i++) {
+        values[i] = (int32_t) rngMultiplyModulo((uint32_t) values[i - RNG_FILL_LANES], block_multiplier);
     }
-    return rnd_seed;
+
+    rng.seed = (uint32_t) values[count - 1];
+}
+
+// Set up one of the independent streams (an rng_streams entry) of a seed.
+void rngSetStream(Rng_t &rng, uint32_t seed, int stream) {
+    rngSetSeed(rng, seed);
+    rngJumpAhead(rng, RNG_STREAM_SPACING * (uint64_t) stream);
+}
+
+uint32_t getRandomSeed() {
+    return rnd_state.seed;
+}
+
+void setRandomSeed(uint32_t seed) {
+    rngSetSeed(rnd_state, seed);
+}
+
+// The game's global stream, for code which can also be given another one
+Rng_t &rndStream() {
+    return rnd_state;
+}
+
+// returns a pseudo-random number from the game's global stream
+int32_t rnd() {
+    return rngNext(rnd_state);
+}
+
+// Fill `values` with the next `count` numbers from the game's global stream
+void rndFill(int32_t *values, int count) {
+    rngFill(rnd_state, values, count);
+}
+
+// Swap the game's global stream with `rng`, so the rnd() based functions
+// draw from `rng` until it is swapped back again.
+void rndSwapStream(Rng_t &rng) {
+    Rng_t global = rnd_state;
+    rnd_state = rng;
+    rng = global;
 }
 
 #ifdef TEST_RNG
@@ -107,6 +210,12 @@ main() {
     if (random == 1043618065L) {
         printf("success!!!\n");
     }
+
+    Rng_t rng;
+    rngSetSeed(rng, 0L);
+    rngJumpAhead(rng, 10000);
+
+    printf("jump ahead z[10001] = %ld, should be 1043618065\n", (int32_t) rng.seed);
 }
 
 #endif
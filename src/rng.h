@@ -8,7 +8,33 @@
 
 #pragma once
 
+// Rng_t holds the state of a single random number stream. Passing one around
+// explicitly makes generation reentrant, while the rnd() functions below
+// keep using the game's global stream.
+typedef struct {
+    uint32_t seed;
+} Rng_t;
+
+// Independent streams of a seed, for code which wants its numbers to be
+// unaffected by how many numbers other parts of the game have used. Each
+// stream starts a set part of the period along from the seed, which must
+// not change, as that would change the games already being played.
+// Streams 0, 1 and 3 are free.
+enum rng_streams {
+    RNG_STORES = 2,
+};
+
 // rng.cpp
+void rngSetSeed(Rng_t &rng, uint32_t seed);
+int32_t rngNext(Rng_t &rng);
+int rngRandomNumber(Rng_t &rng, int max);
+void rngFill(Rng_t &rng, int32_t *values, int count);
+void rngJumpAhead(Rng_t &rng, uint64_t steps);
+void rngSetStream(Rng_t &rng, uint32_t seed, int stream);
+
 uint32_t getRandomSeed();
 void setRandomSeed(uint32_t seed);
+Rng_t &rndStream();
 int32_t rnd();
+void rndFill(int32_t *values, int count);
+void rndSwapStream(Rng_t &rng);
@@ -159,7 +159,7 @@ bool spellDetectTreasureWithinVicinity() {
             Tile_t &tile = dg.floor[y][x];
 
             if (tile.treasure_id != 0 && treasure_list[tile.treasure_id].category_id == TV_GOLD && !caveTileVisible(Coord_t{y, x})) {
-                tile.field_mark = true;
+                dg.floor.field_mark.set(y, x);
                 dungeonLiteSpot(Coord_t{y, x});
                 detected = true;
             }
@@ -178,7 +178,7 @@ bool spellDetectObjectsWithinVicinity() {
             Tile_t &tile = dg.floor[y][x];
 
             if (tile.treasure_id != 0 && treasure_list[tile.treasure_id].category_id < TV_MAX_OBJECT && !caveTileVisible(Coord_t{y, x})) {
-                tile.field_mark = true;
+                dg.floor.field_mark.set(y, x);
                 dungeonLiteSpot(Coord_t{y, x});
                 detected = true;
             }
@@ -201,7 +201,7 @@ bool spellDetectTrapsWithinVicinity() {
             }
 
             if (treasure_list[tile.treasure_id].category_id == TV_INVIS_TRAP) {
-                tile.field_mark = true;
+                dg.floor.field_mark.set(y, x);
                 trapChangeVisibility(Coord_t{y, x});
                 detected = true;
             } else if (treasure_list[tile.treasure_id].category_id == TV_CHEST) {
@@ -229,13 +229,13 @@ bool spellDetectSecretDoorssWithinVicinity() {
             if (treasure_list[tile.treasure_id].category_id == TV_SECRET_DOOR) {
                 // Secret doors
 
-                tile.field_mark = true;
+                dg.floor.field_mark.set(y, x);
                 trapChangeVisibility(Coord_t{y, x});
                 detected = true;
-            } else if ((treasure_list[tile.treasure_id].category_id == TV_UP_STAIR || treasure_list[tile.treasure_id].category_id == TV_DOWN_STAIR) && !tile.field_mark) {
+            } else if ((treasure_list[tile.treasure_id].category_id == TV_UP_STAIR || treasure_list[tile.treasure_id].category_id == TV_DOWN_STAIR) && !dg.floor.field_mark.test(y, x)) {
                 // Staircases
 
-                tile.field_mark = true;
+                dg.floor.field_mark.set(y, x);
                 dungeonLiteSpot(Coord_t{y, x});
                 detected = true;
             }
@@ -249,10 +249,14 @@ bool spellDetectSecretDoorssWithinVicinity() {
 bool spellDetectInvisibleCreaturesWithinVicinity() {
     bool detected = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersInsidePanel(ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
 
-        if (coordInsidePanel(Coord_t{monster.y, monster.x}) && ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_INVISIBLE) != 0u)) {
+        if ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_INVISIBLE) != 0u) {
             monster.lit = true;
 
             // works correctly even if hallucinating
@@ -284,7 +288,7 @@ bool spellLightArea(int y, int x) {
     // NOTE: this is not changed anywhere. A bug or correct? -MRC-
     bool lit = true;
 
-    if (dg.floor[y][x].perma_lit_room && dg.current_level > 0) {
+    if (dg.floor.perma_lit_room.test(y, x) && dg.current_level > 0) {
         dungeonLightRoom(Coord_t{y, x});
     }
 
@@ -292,7 +296,7 @@ bool spellLightArea(int y, int x) {
     // the edge of a room, or next to a destroyed area, etc.
     for (int i = y - 1; i <= y + 1; i++) {
         for (int j = x - 1; j <= x + 1; j++) {
-            dg.floor[i][j].permanent_light = true;
+            dg.floor.permanent_light.set(i, j);
             dungeonLiteSpot(Coord_t{i, j});
         }
     }
@@ -304,26 +308,32 @@ bool spellLightArea(int y, int x) {
 bool spellDarkenArea(int y, int x) {
     bool darkened = false;
 
-    if (dg.floor[y][x].perma_lit_room && dg.current_level > 0) {
-        int half_height = (SCREEN_HEIGHT / 2);
-        int half_width = (SCREEN_WIDTH / 2);
-        int start_row = (y / half_height) * half_height + 1;
-        int start_col = (x / half_width) * half_width + 1;
-        int end_row = start_row + half_height - 1;
-        int end_col = start_col + half_width - 1;
+    Region_t const *region = dungeonRegionAt(Coord_t{y, x});
+
+    if (region != nullptr && dg.floor.perma_lit_room.test(y, x) && dg.current_level > 0) {
+        int start_row = region->top_left.y;
+        int start_col = region->top_left.x;
+        int end_row = region->bottom_right.y;
+        int end_col = region->bottom_right.x;
 
         for (int row = start_row; row <= end_row; row++) {
-            for (int col = start_col; col <= end_col; col++) {
-                Tile_t &tile = dg.floor[row][col];
+            uint64_t const *room = dg.floor.perma_lit_room.row(row);
 
-                if (tile.perma_lit_room && tile.feature_id <= MAX_CAVE_FLOOR) {
-                    tile.permanent_light = false;
-                    tile.feature_id = TILE_DARK_FLOOR;
+            // only the room tiles need looking at
+            for (int word = start_col >> FLOOR_BITS_SHIFT; word <= end_col >> FLOOR_BITS_SHIFT; word++) {
+                for (uint64_t bits = room[word] & floorBitsMask(word, start_col, end_col); bits != 0; bits &= bits - 1) {
+                    int col = (word << FLOOR_BITS_SHIFT) + floorBitsLowest(bits);
+                    Tile_t &tile = dg.floor[row][col];
 
-                    dungeonLiteSpot(Coord_t{row, col});
+                    if (tile.feature_id <= MAX_CAVE_FLOOR) {
+                        dg.floor.permanent_light.reset(row, col);
+                        dungeonSetTileFeature(tile, TILE_DARK_FLOOR);
 
-                    if (!caveTileVisible(Coord_t{row, col})) {
-                        darkened = true;
+                        dungeonLiteSpot(Coord_t{row, col});
+
+                        if (!caveTileVisible(Coord_t{row, col})) {
+                            darkened = true;
+                        }
                     }
                 }
             }
@@ -331,11 +341,9 @@ bool spellDarkenArea(int y, int x) {
     } else {
         for (int row = y - 1; row <= y + 1; row++) {
             for (int col = x - 1; col <= x + 1; col++) {
-                Tile_t &tile = dg.floor[row][col];
-
-                if (tile.feature_id == TILE_CORR_FLOOR && tile.permanent_light) {
+                if (dg.floor[row][col].feature_id == TILE_CORR_FLOOR && dg.floor.permanent_light.test(row, col)) {
                     // permanent_light could have been set by star-lite wand, etc
-                    tile.permanent_light = false;
+                    dg.floor.permanent_light.reset(row, col);
                     darkened = true;
                 }
             }
@@ -349,31 +357,83 @@ bool spellDarkenArea(int y, int x) {
     return darkened;
 }
 
-static void dungeonLightAreaAroundFloorTile(int y, int x) {
-    for (int yy = y - 1; yy <= y + 1; yy++) {
-        for (int xx = x - 1; xx <= x + 1; xx++) {
-            Tile_t &tile = dg.floor[yy][xx];
+static void dungeonMapTile(int y, int x) {
+    Tile_t const &tile = dg.floor[y][x];
 
-            if (tile.feature_id >= MIN_CAVE_WALL) {
-                tile.permanent_light = true;
-            } else if (tile.treasure_id != 0 && treasure_list[tile.treasure_id].category_id >= TV_MIN_VISIBLE && treasure_list[tile.treasure_id].category_id <= TV_MAX_VISIBLE) {
-                tile.field_mark = true;
-            }
+    if (tile.feature_id >= MIN_CAVE_WALL) {
+        dg.floor.permanent_light.set(y, x);
+    } else if (tile.treasure_id != 0 && treasure_list[tile.treasure_id].category_id >= TV_MIN_VISIBLE && treasure_list[tile.treasure_id].category_id <= TV_MAX_VISIBLE) {
+        dg.floor.field_mark.set(y, x);
+    }
+}
+
+// Sets the bits of the floor tiles along a row, from `left` to `right`,
+// then spreads them out by one tile either side.
+static void dungeonFloorsNextTo(int y, int left, int right, uint64_t *bits, int words) {
+    for (int word = 0; word < words; word++) {
+        bits[word] = 0;
+    }
+
+    for (int x = left; x <= right; x++) {
+        if (dg.floor[y][x].feature_id <= MAX_CAVE_FLOOR) {
+            bits[x >> FLOOR_BITS_SHIFT] |= (uint64_t) 1 << (x & FLOOR_BITS_MASK);
         }
     }
+
+    uint64_t previous = 0;
+    for (int word = 0; word < words; word++) {
+        uint64_t current = bits[word];
+        uint64_t next = word + 1 < words ? bits[word + 1] : 0;
+
+        bits[word] = current | (current << 1) | (current >> 1) | (previous >> FLOOR_BITS_MASK) | (next << FLOOR_BITS_MASK);
+        previous = current;
+    }
 }
 
 // Map the current area plus some -RAK-
+// Every tile next to a floor in the area is mapped, which is worked
+// out a row at a time, so each tile only needs mapping once.
 void spellMapCurrentArea() {
     int row_min = dg.panel.top - randomNumber(10);
     int row_max = dg.panel.bottom + randomNumber(10);
     int col_min = dg.panel.left - randomNumber(20);
     int col_max = dg.panel.right + randomNumber(20);
 
-    for (int y = row_min; y <= row_max; y++) {
-        for (int x = col_min; x <= col_max; x++) {
-            if (coordInBounds(Coord_t{y, x}) && dg.floor[y][x].feature_id <= MAX_CAVE_FLOOR) {
-                dungeonLightAreaAroundFloorTile(y, x);
+    // The dungeon edges are all walls, so there
+    // are no floors outside of these bounds.
+    if (row_min < 1) {
+        row_min = 1;
+    }
+    if (row_max > dg.height - 2) {
+        row_max = dg.height - 2;
+    }
+    if (col_min < 1) {
+        col_min = 1;
+    }
+    if (col_max > dg.width - 2) {
+        col_max = dg.width - 2;
+    }
+
+    int words = dg.floor.permanent_light.words_per_row;
+    int rows = row_max - row_min + 1;
+
+    std::vector<uint64_t> near_floors((size_t) (rows * words));
+    for (int row = 0; row < rows; row++) {
+        dungeonFloorsNextTo(row_min + row, col_min, col_max, &near_floors[(size_t) (row * words)], words);
+    }
+
+    for (int y = row_min - 1; y <= row_max + 1; y++) {
+        for (int word = 0; word < words; word++) {
+            uint64_t bits = 0;
+
+            for (int row = y - 1; row <= y + 1; row++) {
+                if (row >= row_min && row <= row_max) {
+                    bits |= near_floors[(size_t) ((row - row_min) * words + word)];
+                }
+            }
+
+            for (; bits != 0; bits &= bits - 1) {
+                dungeonMapTile(y, (word << FLOOR_BITS_SHIFT) + floorBitsLowest(bits));
             }
         }
     }
@@ -482,8 +542,8 @@ bool spellSurroundPlayerWithDoors() {
                 }
 
                 int free_id = popt();
-                tile.feature_id = TILE_BLOCKED_FLOOR;
-                tile.treasure_id = (uint8_t) free_id;
+                dungeonSetTileFeature(tile, TILE_BLOCKED_FLOOR);
+                dungeonPlaceTreasure(Coord_t{y, x}, free_id);
 
                 inventoryItemCopyTo(config::dungeon::objects::OBJ_CLOSED_DOOR, treasure_list[free_id]);
                 dungeonLiteSpot(Coord_t{y, x});
@@ -534,10 +594,14 @@ bool spellDestroyAdjacentDoorsTraps() {
 bool spellDetectMonsters() {
     bool detected = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersInsidePanel(ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
 
-        if (coordInsidePanel(Coord_t{monster.y, monster.x}) && (creatures_list[monster.creature_id].movement & config::monsters::move::CM_INVISIBLE) == 0) {
+        if ((creatures_list[monster.creature_id].movement & config::monsters::move::CM_INVISIBLE) == 0) {
             monster.lit = true;
             detected = true;
 
@@ -595,9 +659,9 @@ void spellLightLine(int x, int y, int direction) {
             continue; // we're done here, break out of the loop
         }
 
-        if (!tile.permanent_light && !tile.temporary_light) {
+        if (!dg.floor.permanent_light.test(y, x) && !dg.floor.temporary_light.test(y, x)) {
             // set permanent_light so that dungeonLiteSpot will work
-            tile.permanent_light = true;
+            dg.floor.permanent_light.set(y, x);
 
             if (tile.feature_id == TILE_LIGHT_FLOOR) {
                 if (coordInsidePanel(Coord_t{y, x})) {
@@ -609,7 +673,7 @@ void spellLightLine(int x, int y, int direction) {
         }
 
         // set permanent_light in case temporary_light was true above
-        tile.permanent_light = true;
+        dg.floor.permanent_light.set(y, x);
 
         if (tile.creature_id > 1) {
             spellLightLineTouchesMonster((int) tile.creature_id);
@@ -657,7 +721,7 @@ bool spellDisarmAllInDirection(int y, int x, int direction) {
                 // Locked or jammed doors become merely closed.
                 item.misc_use = 0;
             } else if (item.category_id == TV_SECRET_DOOR) {
-                tile->field_mark = true;
+                dg.floor.field_mark.set(y, x);
                 trapChangeVisibility(Coord_t{y, x});
                 disarmed = true;
             } else if (item.category_id == TV_CHEST && item.flags != 0) {
@@ -741,10 +805,10 @@ static void spellFireBoltTouchesMonster(Tile_t &tile, int damage, int harm_type,
 
     // light up monster and draw monster, temporarily set
     // permanent_light so that `monsterUpdateVisibility()` will work
-    bool saved_lit_status = tile.permanent_light;
-    tile.permanent_light = true;
+    bool saved_lit_status = dg.floor.permanent_light.test(monster.y, monster.x);
+    dg.floor.permanent_light.set(monster.y, monster.x);
     monsterUpdateVisibility((int) tile.creature_id);
-    tile.permanent_light = saved_lit_status;
+    dg.floor.permanent_light.assign(monster.y, monster.x, saved_lit_status);
 
     // draw monster and clear previous bolt
     putQIO();
@@ -867,8 +931,8 @@ void spellFireBall(int y, int x, int direction, int damage_hp, int spell_type, c
                                 Creature_t const &creature = creatures_list[monster.creature_id];
 
                                 // lite up creature if visible, temp set permanent_light so that monsterUpdateVisibility works
-                                bool saved_lit_status = tile->permanent_light;
-                                tile->permanent_light = true;
+                                bool saved_lit_status = dg.floor.permanent_light.test(row, col);
+                                dg.floor.permanent_light.set(row, col);
                                 monsterUpdateVisibility((int) tile->creature_id);
 
                                 total_hits++;
@@ -891,7 +955,7 @@ void spellFireBall(int y, int x, int direction, int damage_hp, int spell_type, c
                                 if (monsterTakeHit((int) tile->creature_id, damage) >= 0) {
                                     total_kills++;
                                 }
-                                tile->permanent_light = saved_lit_status;
+                                dg.floor.permanent_light.assign(row, col, saved_lit_status);
                             } else if (coordInsidePanel(Coord_t{row, col}) && py.flags.blind < 1) {
                                 panelPutTile('*', Coord_t{row, col});
                             }
@@ -1477,7 +1541,7 @@ bool spellPolymorphMonster(int y, int x, int direction) {
                 morphed = monsterPlaceNew(y, x, randomNumber(monster_levels[MON_MAX_LEVELS] - monster_levels[0]) - 1 + monster_levels[0], false);
 
                 // don't test tile.field_mark here, only permanent_light/temporary_light
-                if (morphed && coordInsidePanel(Coord_t{y, x}) && (tile.temporary_light || tile.permanent_light)) {
+                if (morphed && coordInsidePanel(Coord_t{y, x}) && (dg.floor.temporary_light.test(y, x) || dg.floor.permanent_light.test(y, x))) {
                     morphed = true;
                 }
             } else {
@@ -1542,11 +1606,13 @@ bool spellBuildWall(int y, int x, int direction) {
             }
         }
 
-        tile.feature_id = TILE_MAGMA_WALL;
-        tile.field_mark = false;
+        dungeonSetTileFeature(tile, TILE_MAGMA_WALL);
+        dg.floor.field_mark.reset(y, x);
 
         // Permanently light this wall if it is lit by player's lamp.
-        tile.permanent_light = (tile.temporary_light || tile.permanent_light);
+        if (dg.floor.temporary_light.test(y, x)) {
+            dg.floor.permanent_light.set(y, x);
+        }
         dungeonLiteSpot(Coord_t{y, x});
 
         built = true;
@@ -1601,13 +1667,13 @@ void spellTeleportAwayMonster(int monster_id, int distance_from_player) {
     dungeonMoveCreatureRecord(Coord_t{monster.y, monster.x}, Coord_t{y, x});
     dungeonLiteSpot(Coord_t{monster.y, monster.x});
 
-    monster.y = (uint8_t) y;
-    monster.x = (uint8_t) x;
+    monster.y = (uint16_t) y;
+    monster.x = (uint16_t) x;
 
     // this is necessary, because the creature is
     // not currently visible in its new position.
     monster.lit = false;
-    monster.distance_from_player = (uint8_t) coordDistanceBetween(Coord_t{py.row, py.col}, Coord_t{y, x});
+    monsterUpdateDistance(monster);
 
     monsterUpdateVisibility(monster_id);
 }
@@ -1631,8 +1697,9 @@ void spellTeleportPlayerTo(int y, int x) {
     dungeonMoveCreatureRecord(Coord_t{py.row, py.col}, Coord_t{to_y, to_x});
 
     for (int row = py.row - 1; row <= py.row + 1; row++) {
+        floorBitsResetRange(dg.floor.temporary_light, row, py.col - 1, py.col + 1);
+
         for (int col = py.col - 1; col <= py.col + 1; col++) {
-            dg.floor[row][col].temporary_light = false;
             dungeonLiteSpot(Coord_t{row, col});
         }
     }
@@ -1683,11 +1750,15 @@ bool spellTeleportAwayMonsterInDirection(int y, int x, int direction) {
 bool spellMassGenocide() {
     bool killed = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(Coord_t{py.row, py.col}, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t const &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
-        if (monster.distance_from_player <= config::monsters::MON_MAX_SIGHT && (creature.movement & config::monsters::move::CM_WIN) == 0) {
+        if ((creature.movement & config::monsters::move::CM_WIN) == 0) {
             killed = true;
             dungeonDeleteMonster(id);
         }
@@ -1732,13 +1803,17 @@ bool spellGenocide() {
 bool spellSpeedAllMonsters(int speed) {
     bool speedy = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(Coord_t{py.row, py.col}, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
         auto name = monsterNameDescription(creature.name, monster.lit);
 
-        if (monster.distance_from_player > config::monsters::MON_MAX_SIGHT || !los(py.row, py.col, monster.y, monster.x)) {
+        if (!los(py.row, py.col, monster.y, monster.x)) {
             continue; // do nothing
         }
 
@@ -1771,13 +1846,17 @@ bool spellSpeedAllMonsters(int speed) {
 bool spellSleepAllMonsters() {
     bool asleep = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(Coord_t{py.row, py.col}, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
         auto name = monsterNameDescription(creature.name, monster.lit);
 
-        if (monster.distance_from_player > config::monsters::MON_MAX_SIGHT || !los(py.row, py.col, monster.y, monster.x)) {
+        if (!los(py.row, py.col, monster.y, monster.x)) {
             continue; // do nothing
         }
 
@@ -1805,20 +1884,21 @@ bool spellSleepAllMonsters() {
 bool spellMassPolymorph() {
     bool morphed = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
-        Monster_t const &monster = monsters[id];
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(Coord_t{py.row, py.col}, config::monsters::MON_MAX_SIGHT, ids);
 
-        if (monster.distance_from_player <= config::monsters::MON_MAX_SIGHT) {
-            Creature_t const &creature = creatures_list[monster.creature_id];
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
+        Monster_t const &monster = monsters[id];
+        Creature_t const &creature = creatures_list[monster.creature_id];
 
-            if ((creature.movement & config::monsters::move::CM_WIN) == 0) {
-                int y = monster.y;
-                int x = monster.x;
-                dungeonDeleteMonster(id);
+        if ((creature.movement & config::monsters::move::CM_WIN) == 0) {
+            int y = monster.y;
+            int x = monster.x;
+            dungeonDeleteMonster(id);
 
-                // Place_monster() should always return true here.
-                morphed = monsterPlaceNew(y, x, randomNumber(monster_levels[MON_MAX_LEVELS] - monster_levels[0]) - 1 + monster_levels[0], false);
-            }
+            // Place_monster() should always return true here.
+            morphed = monsterPlaceNew(y, x, randomNumber(monster_levels[MON_MAX_LEVELS] - monster_levels[0]) - 1 + monster_levels[0], false);
         }
     }
 
@@ -1829,10 +1909,14 @@ bool spellMassPolymorph() {
 bool spellDetectEvil() {
     bool detected = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersInsidePanel(ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
 
-        if (coordInsidePanel(Coord_t{monster.y, monster.x}) && ((creatures_list[monster.creature_id].defenses & config::monsters::defense::CD_EVIL) != 0)) {
+        if ((creatures_list[monster.creature_id].defenses & config::monsters::defense::CD_EVIL) != 0) {
             monster.lit = true;
 
             detected = true;
@@ -1931,21 +2015,21 @@ void spellEarthquake() {
                 }
 
                 if (tile.feature_id >= MIN_CAVE_WALL && tile.feature_id != TILE_BOUNDARY_WALL) {
-                    tile.feature_id = TILE_CORR_FLOOR;
-                    tile.permanent_light = false;
-                    tile.field_mark = false;
+                    dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
+                    dg.floor.permanent_light.reset(y, x);
+                    dg.floor.field_mark.reset(y, x);
                 } else if (tile.feature_id <= MAX_CAVE_FLOOR) {
                     int tmp = randomNumber(10);
 
                     if (tmp < 6) {
-                        tile.feature_id = TILE_QUARTZ_WALL;
+                        dungeonSetTileFeature(tile, TILE_QUARTZ_WALL);
                     } else if (tmp < 9) {
-                        tile.feature_id = TILE_MAGMA_WALL;
+                        dungeonSetTileFeature(tile, TILE_MAGMA_WALL);
                     } else {
-                        tile.feature_id = TILE_GRANITE_WALL;
+                        dungeonSetTileFeature(tile, TILE_GRANITE_WALL);
                     }
 
-                    tile.field_mark = false;
+                    dg.floor.field_mark.reset(y, x);
                 }
                 dungeonLiteSpot(Coord_t{y, x});
             }
@@ -1978,10 +2062,14 @@ void spellCreateFood() {
 bool spellDispelCreature(int creature_defense, int damage) {
     bool dispelled = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(Coord_t{py.row, py.col}, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t const &monster = monsters[id];
 
-        if (monster.distance_from_player <= config::monsters::MON_MAX_SIGHT && ((creature_defense & creatures_list[monster.creature_id].defenses) != 0) && los(py.row, py.col, monster.y, monster.x)) {
+        if (((creature_defense & creatures_list[monster.creature_id].defenses) != 0) && los(py.row, py.col, monster.y, monster.x)) {
             Creature_t const &creature = creatures_list[monster.creature_id];
 
             creature_recall[monster.creature_id].defenses |= creature_defense;
@@ -2012,11 +2100,15 @@ bool spellDispelCreature(int creature_defense, int damage) {
 bool spellTurnUndead() {
     bool turned = false;
 
-    for (int id = next_free_monster_id - 1; id >= config::monsters::MON_MIN_INDEX_ID; id--) {
+    int16_t ids[MON_TOTAL_ALLOCATIONS];
+    int count = monstersWithinDistance(Coord_t{py.row, py.col}, config::monsters::MON_MAX_SIGHT, ids);
+
+    for (int i = 0; i < count; i++) {
+        int id = ids[i];
         Monster_t &monster = monsters[id];
         Creature_t const &creature = creatures_list[monster.creature_id];
 
-        if (monster.distance_from_player <= config::monsters::MON_MAX_SIGHT && ((creature.defenses & config::monsters::defense::CD_UNDEAD) != 0) && los(py.row, py.col, monster.y, monster.x)) {
+        if (((creature.defenses & config::monsters::defense::CD_UNDEAD) != 0) && los(py.row, py.col, monster.y, monster.x)) {
             auto name = monsterNameDescription(creature.name, monster.lit);
 
             if (py.misc.level + 1 > creature.level || randomNumber(5) == 1) {
@@ -2042,7 +2134,7 @@ bool spellTurnUndead() {
 void spellWardingGlyph() {
     if (dg.floor[py.row][py.col].treasure_id == 0) {
         int free_id = popt();
-        dg.floor[py.row][py.col].treasure_id = (uint8_t) free_id;
+        dungeonPlaceTreasure(Coord_t{py.row, py.col}, free_id);
         inventoryItemCopyTo(config::dungeon::objects::OBJ_SCARE_MON, treasure_list[free_id]);
     }
 }
@@ -2164,30 +2256,30 @@ static void replaceSpot(int y, int x, int typ) {
         case 1:
         case 2:
         case 3:
-            tile.feature_id = TILE_CORR_FLOOR;
+            dungeonSetTileFeature(tile, TILE_CORR_FLOOR);
             break;
         case 4:
         case 7:
         case 10:
-            tile.feature_id = TILE_GRANITE_WALL;
+            dungeonSetTileFeature(tile, TILE_GRANITE_WALL);
             break;
         case 5:
         case 8:
         case 11:
-            tile.feature_id = TILE_MAGMA_WALL;
+            dungeonSetTileFeature(tile, TILE_MAGMA_WALL);
             break;
         case 6:
         case 9:
         case 12:
-            tile.feature_id = TILE_QUARTZ_WALL;
+            dungeonSetTileFeature(tile, TILE_QUARTZ_WALL);
             break;
         default:
             break;
     }
 
-    tile.permanent_light = false;
-    tile.field_mark = false;
-    tile.perma_lit_room = false; // this is no longer part of a room
+    dg.floor.permanent_light.reset(y, x);
+    dg.floor.field_mark.reset(y, x);
+    dg.floor.perma_lit_room.reset(y, x); // this is no longer part of a room
 
     if (tile.treasure_id != 0) {
         (void) dungeonDeleteObject(Coord_t{y, x});;
@@ -35,6 +35,8 @@ void storeInitializeOwners() {
             item.cost = 0;
         }
     }
+
+    storeMaintenanceInitialize();
 }
 
 // Comments vary. -RAK-
@@ -1062,6 +1064,8 @@ void storeEnter(int store_id) {
         return;
     }
 
+    storeMaintenanceCatchUp();
+
     int current_top_item_id = 0;
     displayStore(stores[store_id], store_owners[store.owner_id].name, current_top_item_id);
 
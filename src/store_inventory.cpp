@@ -12,6 +12,11 @@
 
 Store_t stores[MAX_STORES];
 
+// Store maintenance draws from its own stream, so the rounds can be put off
+// until the stores are next looked at, and still stock exactly the same items.
+Rng_t store_maintenance_rng;
+static int maintenance_rounds_due = 0;
+
 static void storeItemInsert(int store_id, int pos, int32_t i_cost, Inventory_t *item);
 static void storeItemCreate(int store_id, int16_t max_cost);
 
@@ -23,8 +28,20 @@ static int32_t getRingAmuletBuyPrice(Inventory_t const &item);
 static int32_t getWandStaffBuyPrice(Inventory_t const &item);
 static int32_t getPickShovelBuyPrice(Inventory_t const &item);
 
+// Start the maintenance stream for a new game, from the town seed.
+void storeMaintenanceInitialize() {
+    rngSetStream(store_maintenance_rng, game.town_seed, RNG_STORES);
+    maintenance_rounds_due = 0;
+}
+
+// Another round of maintenance is due, which is left until the
+// player enters a store or the game is saved.
+void storeMaintenanceDue() {
+    maintenance_rounds_due++;
+}
+
 // Initialize and up-keep the store's inventory. -RAK-
-void storeMaintenance() {
+static void storeMaintenance() {
     for (int store_id = 0; store_id < MAX_STORES; store_id++) {
         Store_t &store = stores[store_id];
 
@@ -54,6 +71,21 @@ void storeMaintenance() {
     }
 }
 
+// Do all the rounds of maintenance that are due.
+void storeMaintenanceCatchUp() {
+    if (maintenance_rounds_due == 0) {
+        return;
+    }
+
+    rndSwapStream(store_maintenance_rng);
+
+    for (; maintenance_rounds_due > 0; maintenance_rounds_due--) {
+        storeMaintenance();
+    }
+
+    rndSwapStream(store_maintenance_rng);
+}
+
 // Returns the value for any given object -RAK-
 int32_t storeItemValue(Inventory_t const &item) {
     int32_t value;
@@ -369,5 +401,5 @@ static void storeItemCreate(int store_id, int16_t max_cost) {
         }
     }
 
-    pusht((uint8_t) free_id);
+    pusht(free_id);
 }
@@ -86,15 +86,14 @@ void drawDungeonPanel() {
 
     // Top to bottom
     for (int y = dg.panel.top; y <= dg.panel.bottom; y++) {
-        eraseLine(Coord_t{line++, 13});
-
-        // Left to right
+        // Left to right, blanks included, as only the
+        // tiles which have changed reach the terminal.
         for (int x = dg.panel.left; x <= dg.panel.right; x++) {
-            char ch = caveGetTileSymbol(Coord_t{y, x});
-            if (ch != ' ') {
-                panelPutTile(ch, Coord_t{y, x});
-            }
+            panelPutTile(caveGetTileSymbol(Coord_t{y, x}), Coord_t{y, x});
         }
+
+        // Clear whatever is past the right edge of the panel
+        eraseLine(Coord_t{line++, 13 + SCREEN_WIDTH});
     }
 }
 
@@ -120,17 +119,17 @@ void dungeonResetView() {
 
     // A room of light should be lit.
     if (tile.feature_id == TILE_LIGHT_FLOOR) {
-        if (py.flags.blind < 1 && !tile.permanent_light) {
+        if (py.flags.blind < 1 && !dg.floor.permanent_light.test(py.row, py.col)) {
             dungeonLightRoom(Coord_t{py.row, py.col});
         }
         return;
     }
 
     // In doorway of light-room?
-    if (tile.perma_lit_room && py.flags.blind < 1) {
+    if (dg.floor.perma_lit_room.test(py.row, py.col) && py.flags.blind < 1) {
         for (int i = py.row - 1; i <= py.row + 1; i++) {
             for (int j = py.col - 1; j <= py.col + 1; j++) {
-                if (dg.floor[i][j].feature_id == TILE_LIGHT_FLOOR && !dg.floor[i][j].permanent_light) {
+                if (dg.floor[i][j].feature_id == TILE_LIGHT_FLOOR && !dg.floor.permanent_light.test(i, j)) {
                     dungeonLightRoom(Coord_t{i, j});
                 }
             }
@@ -59,10 +59,14 @@ extern int16_t last_message_id;
 // TODO: should we use the the same Coord_t for the dungeon and UI?
 bool terminalInitialize();
 void terminalRestore();
+void terminalSetHeadless();
+bool terminalIsHeadless();
 void terminalSaveScreen();
 void terminalRestoreScreen();
 void terminalBellSound();
 void putQIO();
+void terminalFastForwardStart();
+void terminalFastForwardEnd();
 void flushInputBuffer();
 void clearScreen();
 void clearToBottom(int row);
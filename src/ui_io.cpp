@@ -17,6 +17,27 @@ static bool curses_on = false;
 // Spare window for saving the screen. -CJS-
 static WINDOW *save_screen;
 
+// Headless mode replaces curses with a null terminal: all output goes to an
+// in-memory character grid, and keystrokes are read from standard input
+// (normally a redirected script file). Used for unattended batch runs.
+static bool headless_mode = false;
+
+// The screen grid holds the character last written to each cell. When headless
+// it is the only screen there is, otherwise it is a copy of the curses screen,
+// which lets panelPutTile() skip the tiles already showing. A '\0' cell is not
+// known, and never matches.
+constexpr int SCREEN_GRID_ROWS = 24;
+constexpr int SCREEN_GRID_COLS = 80;
+
+static char screen_grid[SCREEN_GRID_ROWS][SCREEN_GRID_COLS];
+static char saved_screen_grid[SCREEN_GRID_ROWS][SCREEN_GRID_COLS];
+static Coord_t screen_cursor = Coord_t{0, 0};
+
+// While fast forwarding through a rest, repeated command or run, putQIO()
+// leaves the terminal alone, and it is brought up to date just the once
+// when the fast forward ends, or before waiting on a key.
+static bool fast_forwarding = false;
+
 int eof_flag = 0;             // Is used to signal EOF/HANGUP condition
 bool panic_save = false;      // True if playing from a panic save
 
@@ -36,8 +57,175 @@ static void moriaTerminalInitialize() {
     curses_on = true;
 }
 
+// The screen* functions are the only place output reaches the terminal,
+// so the headless grid and curses can be swapped in one place.
+
+static bool screenGridContains(Coord_t coords) {
+    return coords.y >= 0 && coords.y < SCREEN_GRID_ROWS && coords.x >= 0 && coords.x < SCREEN_GRID_COLS;
+}
+
+// The curses terminal may be wider than the grid, which
+// changes where the cursor wraps onto the next line.
+static int screenColumns() {
+    if (headless_mode) {
+        return SCREEN_GRID_COLS;
+    }
+    return COLS;
+}
+
+static bool screenMove(Coord_t coords) {
+    if (!headless_mode) {
+        if (move(coords.y, coords.x) == ERR) {
+            return false;
+        }
+        screen_cursor = coords;
+        return true;
+    }
+
+    if (!screenGridContains(coords)) {
+        return false;
+    }
+    screen_cursor = coords;
+
+    return true;
+}
+
+static void screenAddChar(char ch) {
+    if (!headless_mode) {
+        (void) addch((chtype) ch);
+
+        // curses moves the cursor its own way for control characters,
+        // after which nothing on the grid can be trusted.
+        if (ch < ' ' || ch > '~') {
+            (void) memset(screen_grid, '\0', sizeof(screen_grid));
+            getyx(stdscr, screen_cursor.y, screen_cursor.x);
+            return;
+        }
+    } else if (screen_cursor.y >= SCREEN_GRID_ROWS) {
+        return;
+    }
+
+    if (screenGridContains(screen_cursor)) {
+        screen_grid[screen_cursor.y][screen_cursor.x] = ch;
+    }
+
+    // wrap onto the next line, the same as curses does
+    screen_cursor.x++;
+    if (screen_cursor.x >= screenColumns()) {
+        screen_cursor.x = 0;
+        screen_cursor.y++;
+    }
+}
+
+static bool screenPutChar(char ch, Coord_t coords) {
+    if (!screenMove(coords)) {
+        return false;
+    }
+    screenAddChar(ch);
+
+    return true;
+}
+
+static void screenAddString(const char *str) {
+    for (; *str != '\0'; str++) {
+        screenAddChar(*str);
+    }
+}
+
+static bool screenPutString(const char *str, Coord_t coords) {
+    if (!screenMove(coords)) {
+        return false;
+    }
+    screenAddString(str);
+
+    return true;
+}
+
+// Blanks the grid from the cursor to the end of its line.
+static void screenGridClearToEOL() {
+    if (screen_cursor.y < 0 || screen_cursor.y >= SCREEN_GRID_ROWS || screen_cursor.x >= SCREEN_GRID_COLS) {
+        return;
+    }
+
+    int x = screen_cursor.x < 0 ? 0 : screen_cursor.x;
+    char *row = screen_grid[screen_cursor.y];
+    (void) memset(&row[x], ' ', (size_t) (SCREEN_GRID_COLS - x));
+}
+
+static void screenClearToEOL() {
+    if (!headless_mode) {
+        (void) clrtoeol();
+    }
+
+    screenGridClearToEOL();
+}
+
+static void screenClearToBottom() {
+    if (!headless_mode) {
+        (void) clrtobot();
+    }
+
+    screenGridClearToEOL();
+    for (int y = screen_cursor.y + 1; y < SCREEN_GRID_ROWS; y++) {
+        if (y >= 0) {
+            (void) memset(screen_grid[y], ' ', SCREEN_GRID_COLS);
+        }
+    }
+}
+
+static void screenClear() {
+    if (!headless_mode) {
+        (void) clear();
+    }
+
+    (void) memset(screen_grid, ' ', sizeof(screen_grid));
+    screen_cursor = Coord_t{0, 0};
+}
+
+// The character already showing at the cell is `ch`.
+static bool screenShowing(char ch, Coord_t coords) {
+    return screenGridContains(coords) && screen_grid[coords.y][coords.x] == ch;
+}
+
+static void screenRefresh() {
+    if (!headless_mode) {
+        (void) refresh();
+    }
+}
+
+// Returns the next key from the terminal, or from the input script when
+// running headless. EOF is returned when there is no more input.
+static int screenReadKey() {
+    if (replayIsPlaying()) {
+        return replayNextKey();
+    }
+
+    if (!headless_mode) {
+        return getch();
+    }
+
+    return fgetc(stdin);
+}
+
+// Write the headless screen to stdout, with trailing blanks removed.
+static void headlessDumpScreen() {
+    for (auto &row : screen_grid) {
+        int length = SCREEN_GRID_COLS;
+        while (length > 0 && (row[length - 1] == ' ' || row[length - 1] == '\0')) {
+            length--;
+        }
+        (void) printf("%.*s\n", length, row);
+    }
+    (void) fflush(stdout);
+}
+
 // initializes the terminal / curses routines
 bool terminalInitialize() {
+    if (headless_mode) {
+        screenClear();
+        return true;
+    }
+
     initscr();
 
     // Check we have enough screen. -CJS-
@@ -54,7 +242,7 @@ bool terminalInitialize() {
 
     moriaTerminalInitialize();
 
-    (void) clear();
+    screenClear();
     (void) refresh();
 
     return true;
@@ -62,6 +250,13 @@ bool terminalInitialize() {
 
 // Put the terminal in the original mode. -CJS-
 void terminalRestore() {
+    // There is no terminal to restore when headless, so instead
+    // leave the final screen on stdout for whoever ran the batch.
+    if (headless_mode) {
+        headlessDumpScreen();
+        return;
+    }
+
     if (!curses_on) {
         return;
     }
@@ -82,20 +277,37 @@ void terminalRestore() {
     curses_on = false;
 }
 
+// Switch to the null terminal backend, must be called before terminalInitialize().
+void terminalSetHeadless() {
+    headless_mode = true;
+}
+
+bool terminalIsHeadless() {
+    return headless_mode;
+}
+
 void terminalSaveScreen() {
-    overwrite(stdscr, save_screen);
+    (void) memcpy(saved_screen_grid, screen_grid, sizeof(screen_grid));
+
+    if (!headless_mode) {
+        overwrite(stdscr, save_screen);
+    }
 }
 
 void terminalRestoreScreen() {
-    overwrite(save_screen, stdscr);
-    touchwin(stdscr);
+    (void) memcpy(screen_grid, saved_screen_grid, sizeof(screen_grid));
+
+    if (!headless_mode) {
+        overwrite(save_screen, stdscr);
+        touchwin(stdscr);
+    }
 }
 
 void terminalBellSound() {
     putQIO();
 
     // The player can turn off beeps if they find them annoying.
-    if (config::options::error_beep_sound) {
+    if (config::options::error_beep_sound && !headless_mode) {
         (void) write(1, "\007", 1);
     }
 }
@@ -105,7 +317,22 @@ void putQIO() {
     // Let inventoryExecuteCommand() know something has changed.
     screen_has_changed = true;
 
-    (void) refresh();
+    if (!fast_forwarding) {
+        screenRefresh();
+    }
+}
+
+void terminalFastForwardStart() {
+    fast_forwarding = true;
+}
+
+void terminalFastForwardEnd() {
+    if (!fast_forwarding) {
+        return;
+    }
+
+    fast_forwarding = false;
+    putQIO();
 }
 
 // Flush the buffer -RAK-
@@ -122,21 +349,21 @@ void clearScreen() {
     if (message_ready_to_print) {
         printMessage(CNIL);
     }
-    (void) clear();
+    screenClear();
 }
 
 void clearToBottom(int row) {
-    (void) move(row, 0);
-    clrtobot();
+    (void) screenMove(Coord_t{row, 0});
+    screenClearToBottom();
 }
 
 // move cursor to a given y, x position
 void moveCursor(Coord_t coords) {
-    (void) move(coords.y, coords.x);
+    (void) screenMove(coords);
 }
 
 void addChar(char ch, Coord_t coords) {
-    if (mvaddch(coords.y, coords.x, ch) == ERR) {
+    if (!screenPutChar(ch, coords)) {
         abort();
     }
 }
@@ -152,7 +379,7 @@ void putString(const char *out_str, Coord_t coords) {
     (void) strncpy(str, out_str, (size_t) (79 - coords.x));
     str[79 - coords.x] = '\0';
 
-    if (mvaddstr(coords.y, coords.x, str) == ERR) {
+    if (!screenPutString(str, coords)) {
         abort();
     }
 }
@@ -163,8 +390,8 @@ void putStringClearToEOL(const std::string &str, Coord_t coords) {
         printMessage(CNIL);
     }
 
-    (void) move(coords.y, coords.x);
-    clrtoeol();
+    (void) screenMove(coords);
+    screenClearToEOL();
     putString(str.c_str(), coords);
 }
 
@@ -174,8 +401,8 @@ void eraseLine(Coord_t coords) {
         printMessage(CNIL);
     }
 
-    (void) move(coords.y, coords.x);
-    clrtoeol();
+    (void) screenMove(coords);
+    screenClearToEOL();
 }
 
 // Moves the cursor to a given interpolated y, x position -RAK-
@@ -184,7 +411,7 @@ void panelMoveCursor(Coord_t coords) {
     coords.y -= dg.panel.row_prt;
     coords.x -= dg.panel.col_prt;
 
-    if (move(coords.y, coords.x) == ERR) {
+    if (!screenMove(coords)) {
         abort();
     }
 }
@@ -196,12 +423,22 @@ void panelPutTile(char ch, Coord_t coords) {
     coords.y -= dg.panel.row_prt;
     coords.x -= dg.panel.col_prt;
 
-    if (mvaddch(coords.y, coords.x, ch) == ERR) {
+    // The tile is already showing, so only the cursor moves on.
+    if (screenShowing(ch, coords)) {
+        (void) screenMove(Coord_t{coords.y, coords.x + 1});
+        return;
+    }
+
+    if (!screenPutChar(ch, coords)) {
         abort();
     }
 }
 
 static Coord_t currentCursorPosition() {
+    if (headless_mode) {
+        return screen_cursor;
+    }
+
     int y, x;
     getyx(stdscr, y, x);
     return Coord_t{y, x};
@@ -214,16 +451,16 @@ void messageLinePrintMessage(std::string message) {
     Coord_t coords = currentCursorPosition();
 
     // move to beginning of message line, and clear it
-    move(0, 0);
-    clrtoeol();
+    (void) screenMove(Coord_t{0, 0});
+    screenClearToEOL();
 
     // truncate message if it's too long!
     message.resize(79);
 
-    addstr(message.c_str());
+    screenAddString(message.c_str());
 
     // restore cursor to old position
-    move(coords.y, coords.x);
+    (void) screenMove(coords);
 }
 
 // deleteMessageLine will delete all text from the message line (0,0).
@@ -233,11 +470,11 @@ void messageLineClear() {
     Coord_t coords = currentCursorPosition();
 
     // move to beginning of message line, and clear it
-    move(0, 0);
-    clrtoeol();
+    (void) screenMove(Coord_t{0, 0});
+    screenClearToEOL();
 
     // restore cursor to old position
-    move(coords.y, coords.x);
+    (void) screenMove(coords);
 }
 
 // Outputs message to top line of screen
@@ -278,8 +515,8 @@ void printMessage(const char *msg) {
     }
 
     if (!combine_messages) {
-        (void) move(MSG_LINE, 0);
-        clrtoeol();
+        (void) screenMove(Coord_t{MSG_LINE, 0});
+        screenClearToEOL();
     }
 
     // Make the null string a special case. -CJS-
@@ -329,11 +566,18 @@ void printMessageNoCommandInterrupt(const std::string &msg) {
 // terminal, so that this operation can always be performed at
 // any input prompt. getKeyInput() never returns ^R.
 char getKeyInput() {
+    fast_forwarding = false;
     putQIO();         // Dump IO buffer
     game.command_count = 0; // Just to be safe -CJS-
 
     while (true) {
-        int ch = getch();
+        int ch = screenReadKey();
+
+        // The end of a replay ends the game there and then. It is not
+        // saved or scored, as it is not the player's own game.
+        if (ch == EOF && replayIsPlaying()) {
+            exitProgram();
+        }
 
         // some machines may not sign extend.
         if (ch == EOF) {
@@ -342,7 +586,7 @@ char getKeyInput() {
 
             eof_flag++;
 
-            (void) refresh();
+            screenRefresh();
 
             if (!game.character_generated || game.character_saved) {
                 endGame();
@@ -364,7 +608,8 @@ char getKeyInput() {
             return ESCAPE;
         }
 
-        if (ch != CTRL_KEY('R')) {
+        if (ch != CTRL_KEY('R') || headless_mode) {
+            replayRecordKey((char) ch);
             return (char) ch;
         }
 
@@ -389,13 +634,13 @@ bool getCommand(const std::string &prompt, char &command) {
 // Gets a string terminated by <RETURN>
 // Function returns false if <ESCAPE> is input
 bool getStringInput(char *in_str, Coord_t coords, int slen) {
-    (void) move(coords.y, coords.x);
+    (void) screenMove(coords);
 
     for (int i = slen; i > 0; i--) {
-        (void) addch(' ');
+        screenAddChar(' ');
     }
 
-    (void) move(coords.y, coords.x);
+    (void) screenMove(coords);
 
     int start_col = coords.x;
     int end_col = coords.x + slen - 1;
@@ -432,7 +677,7 @@ bool getStringInput(char *in_str, Coord_t coords, int slen) {
                 if ((isprint(key) == 0) || coords.x > end_col) {
                     terminalBellSound();
                 } else {
-                    mvaddch(coords.y, coords.x, (char) key);
+                    (void) screenPutChar((char) key, coords);
                     *p++ = (char) key;
                     coords.x++;
                 }
@@ -457,16 +702,13 @@ bool getStringInput(char *in_str, Coord_t coords, int slen) {
 bool getInputConfirmation(const std::string &prompt) {
     putStringClearToEOL(prompt, Coord_t{0, 0});
 
-    int y, x;
-    getyx(stdscr, y, x);
+    Coord_t coords = currentCursorPosition();
 
-    if (x > 73) {
-        (void) move(0, 73);
-    } else if (y != 0) {
-        // use `y` to prevent compiler warning.
+    if (coords.x > 73) {
+        (void) screenMove(Coord_t{0, 73});
     }
 
-    (void) addstr(" [y/n]");
+    screenAddString(" [y/n]");
 
     char input = ' ';
     while (input == ' ') {
@@ -498,7 +740,7 @@ void waitForContinueKey(int line_number) {
 // might hack a static accumulation of times to wait. When the accumulation reaches
 // a certain point, sleep for a second. There would need to be a way of resetting
 // the count, with a call made for commands like run or rest.
-bool checkForNonBlockingKeyPress(int microseconds) {
+static bool terminalKeyPressWaiting(int microseconds) {
 #ifdef _WIN32
     (void) microseconds;
 
@@ -532,6 +774,20 @@ bool checkForNonBlockingKeyPress(int microseconds) {
 #endif
 }
 
+bool checkForNonBlockingKeyPress(int microseconds) {
+    // A replay knows exactly which polls found a key, so never wait on it.
+    if (replayIsPlaying()) {
+        return replayNextKeyPress();
+    }
+
+    // Neither can a script be interrupted.
+    bool key_pressed = !headless_mode && terminalKeyPressWaiting(microseconds);
+
+    replayRecordKeyPress(key_pressed);
+
+    return key_pressed;
+}
+
 // Find a default user name from the system.
 void getDefaultPlayerName(char *buffer) {
     // Gotta have some name
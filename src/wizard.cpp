@@ -35,16 +35,16 @@ bool enterWizardMode() {
 void wizardLightUpDungeon() {
     bool flag;
 
-    flag = !dg.floor[py.row][py.col].permanent_light;
+    flag = !dg.floor.permanent_light.test(py.row, py.col);
 
     for (int y = 0; y < dg.height; y++) {
         for (int x = 0; x < dg.width; x++) {
             if (dg.floor[y][x].feature_id <= MAX_CAVE_FLOOR) {
                 for (int yy = y - 1; yy <= y + 1; yy++) {
                     for (int xx = x - 1; xx <= x + 1; xx++) {
-                        dg.floor[yy][xx].permanent_light = flag;
+                        dg.floor.permanent_light.assign(yy, xx, flag);
                         if (!flag) {
-                            dg.floor[yy][xx].field_mark = false;
+                            dg.floor.field_mark.reset(yy, xx);
                         }
                     }
                 }
@@ -308,7 +308,7 @@ void wizardGenerateObject() {
 
             // place the object
             int free_treasure_id = popt();
-            dg.floor[j][k].treasure_id = (uint8_t) free_treasure_id;
+            dungeonPlaceTreasure(Coord_t{j, k}, free_treasure_id);
             inventoryItemCopyTo(id, treasure_list[free_treasure_id]);
             magicTreasureMagicalAbility(free_treasure_id, dg.current_level);
 
@@ -471,7 +471,7 @@ void wizardCreateObjects() {
         number = popt();
 
         treasure_list[number] = forge;
-        tile.treasure_id = (uint8_t) number;
+        dungeonPlaceTreasure(Coord_t{py.row, py.col}, number);
 
         printMessage("Allocated.");
     } else {